@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_ACCURACYEVALUATOR_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_ACCURACYEVALUATOR_H
+
+#include <string>
+#include <vector>
+#include <ResultReader.h>
+
+/**
+ * @brief The accuracy of an estimator with respect to measured makespans
+ */
+struct estimator_accuracy {
+    std::string name;
+    /** @brief Number of machine pairs (for a same app/num_tasks/data_size/type) wrongly/rightly ranked */
+    unsigned long num_wrong;
+    unsigned long num_right;
+    /** @brief Number of measured makespans for which there is an estimate */
+    unsigned long num_estimates;
+    /** @brief Relative errors |estimate - real| / real */
+    double mean_relative_error;
+    double median_relative_error;
+    double max_relative_error;
+};
+
+/**
+ * @brief A class that evaluates the accuracy of estimates against measured makespans (what python/process.py does)
+ */
+class AccuracyEvaluator {
+
+public:
+    /**
+     * @brief Evaluate estimates
+     *
+     * @param real: measured makespans (columns app, num_tasks, data_size, type, makespan, machine)
+     * @param model: estimates (columns app, num_tasks, data_size, type, machine, and one column per
+     *               estimator, whose name starts with "estimate" and has no "_")
+     * @param num_threads: the number of threads to use
+     * @return the accuracy of each estimator
+     *
+     * @throw std::invalid_argument
+     */
+    static std::vector<struct estimator_accuracy> evaluate(const struct result_table &real,
+                                                           const struct result_table &model,
+                                                           unsigned long num_threads);
+};
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_ACCURACYEVALUATOR_H
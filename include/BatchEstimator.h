@@ -0,0 +1,39 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_BATCHESTIMATOR_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_BATCHESTIMATOR_H
+
+#include <vector>
+#include <PlatformSpec.h>
+#include <WorkflowSummary.h>
+
+/**
+ * @brief Compute the critical path estimate for many platform configurations at once. Configurations
+ *        that have the same task execution time and per-node I/O bandwidths (e.g., a sweep over
+ *        core counts) order the tasks of each level identically, so each level is sorted once per
+ *        such group, and the tasks are then walked once for all the configurations in the group,
+ *        one configuration per SIMD lane (AVX-512 or AVX2 if enabled at compile time, scalar code
+ *        otherwise), each lane adding a task to its full batches or to its last batch depending on
+ *        the task's rank. Estimates are bitwise identical to estimate_makespan_critical_path().
+ *        Grouped summaries, and summaries with multi-core tasks or overlapped tasks, are estimated one
+ *        configuration at a time.
+ *
+ * @param summary: the workflow summary
+ * @param configs: the platform configurations
+ * @param num_threads: the number of threads (levels are then estimated concurrently)
+ * @return the estimates, in the same order as the configurations
+ *
+ * @throw std::invalid_argument
+ */
+std::vector<double> estimate_makespan_critical_path_batch(const WorkflowSummary &summary,
+                                                          const std::vector<struct platform_config> &configs,
+                                                          unsigned long num_threads = 1);
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_BATCHESTIMATOR_H
@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_CORECOUNTSEARCH_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_CORECOUNTSEARCH_H
+
+#include <functional>
+#include <vector>
+#include <WorkflowSummary.h>
+
+/**
+ * @brief A class that searches for the number of nodes to use on a platform, based on the critical path
+ *        estimate. This estimate only depends on the number of cores through the number of nodes, and
+ *        its big steps are where the number of batches of a level changes: a level of W tasks has k
+ *        batches for numbers of nodes from ceil(W / (k * p)) to ceil(W / ((k - 1) * p)) - 1 (p cores per
+ *        node). These breakpoints are the candidates of the search; between two of them, only I/O
+ *        contention changes.
+ */
+class CoreCountSearch {
+
+public:
+
+    /**
+     * @brief Get the numbers of nodes at which the number of batches of some level changes
+     *
+     * @param summary: the workflow summary
+     * @param num_cores_per_node: the number of cores per node
+     * @param max_num_nodes: the largest number of nodes
+     * @return candidate numbers of nodes, in increasing order (always including 1 and max_num_nodes)
+     */
+    static std::vector<unsigned long> getCandidateNumNodes(const WorkflowSummary &summary,
+                                                           unsigned long num_cores_per_node,
+                                                           unsigned long max_num_nodes);
+
+    /**
+     * @brief Find the smallest number of nodes whose estimate meets a deadline, assuming estimates do not
+     *        increase with the number of nodes: a binary search over candidates brackets the smallest
+     *        candidate that meets the deadline, and a binary search between that candidate and the previous
+     *        one finds the smallest number of nodes.
+     *
+     * @param candidates: candidate numbers of nodes, in increasing order
+     * @param estimate: the estimate for a given number of nodes
+     * @param deadline: the deadline, in seconds
+     * @return the smallest number of nodes, or 0 if even the largest candidate misses the deadline
+     */
+    static unsigned long findMinimalNumNodes(const std::vector<unsigned long> &candidates,
+                                             const std::function<double(unsigned long)> &estimate,
+                                             double deadline);
+
+    /**
+     * @brief Get the Pareto front of (number of nodes, makespan) points, i.e., the points whose makespan
+     *        is lower than that of all the points with fewer nodes
+     *
+     * @param num_nodes: numbers of nodes, in increasing order
+     * @param makespans: the corresponding makespans
+     * @return the indices of the points on the Pareto front
+     */
+    static std::vector<unsigned long> getParetoFront(const std::vector<unsigned long> &num_nodes,
+                                                     const std::vector<double> &makespans);
+};
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_CORECOUNTSEARCH_H
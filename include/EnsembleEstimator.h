@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_ENSEMBLEESTIMATOR_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_ENSEMBLEESTIMATOR_H
+
+#include <string>
+#include <vector>
+#include <PlatformSpec.h>
+#include <WorkflowSummary.h>
+#include <MakespanEstimators.h>
+
+/**
+ * @brief How the workflows of an ensemble share the cores of the allocation
+ */
+enum ensemble_policy {
+    /** @brief The tasks of a level of all workflows are batched together, longest first */
+    FAIR_SHARE = 0,
+    /** @brief The tasks of a level are batched by decreasing workflow priority, and then longest first */
+    PRIORITY = 1
+};
+
+/**
+ * @brief The critical path estimate of an ensemble of workflows
+ */
+struct ensemble_estimate {
+    /** @brief Makespan of the ensemble, in seconds */
+    double makespan;
+    /** @brief Completion time of each workflow, in seconds */
+    std::vector<double> completion_times;
+};
+
+/**
+ * @brief A class that estimates the makespan of an ensemble of workflows that run concurrently on the same
+ *        allocation, sharing its cores and I/O bandwidths, and the completion time of each workflow. The
+ *        level-by-level model of the critical path estimate is applied to the levels of the ensemble (see
+ *        WorkflowSummary::createUnion()), so that the batches of a level, and their I/O contention, are made
+ *        of the tasks of all workflows. A workflow completes when the batch of the last task of its last level
+ *        does: at the end of that level with the fair-share policy, in which all workflows progress together,
+ *        and as soon as its tasks are done with the priority policy.
+ */
+class EnsembleEstimator {
+
+public:
+    /**
+     * @brief Estimate the makespan of an ensemble, and the completion time of each workflow
+     *
+     * @param ensemble: the (non-grouped) ensemble summary
+     * @param config: the platform configuration
+     * @param policy: the policy
+     * @param priorities: the priority of each workflow (the higher, the earlier its tasks run, ties being
+     *                    broken by workflow order), for the priority policy
+     * @param workspace: the workspace
+     * @return the ensemble estimate (with the fair-share policy, its makespan is the critical path estimate
+     *         of the ensemble summary)
+     *
+     * @throw std::invalid_argument
+     */
+    static struct ensemble_estimate estimate(const WorkflowSummary &ensemble,
+                                             const struct platform_config &config,
+                                             enum ensemble_policy policy,
+                                             const std::vector<double> &priorities,
+                                             EstimationWorkspace &workspace);
+
+    /**
+     * @brief Parse a policy name
+     * @param name: "fair_share" or "priority"
+     * @return a policy
+     *
+     * @throw std::invalid_argument
+     */
+    static enum ensemble_policy parsePolicy(const std::string &name);
+
+private:
+    static double estimateLevelByPriority(const WorkflowSummary &ensemble,
+                                          unsigned long level,
+                                          const struct platform_config &config,
+                                          const std::vector<unsigned long> &ranks,
+                                          double start,
+                                          EstimationWorkspace &workspace,
+                                          std::vector<double> &completion_times);
+};
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_ENSEMBLEESTIMATOR_H
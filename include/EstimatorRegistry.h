@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_ESTIMATORREGISTRY_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_ESTIMATORREGISTRY_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <PlatformSpec.h>
+#include <WorkflowSummary.h>
+
+/**
+ * @brief A makespan estimator. Estimators only see the (shared, read-only) workflow summary, which
+ *        is computed once per workflow, and a platform configuration, so that adding estimators does
+ *        not add to the cost of loading and summarizing workflows.
+ */
+class MakespanEstimator {
+
+public:
+    virtual ~MakespanEstimator() = default;
+
+    /**
+     * @brief Get the name of the estimator, which is also the name of its result column
+     * @return a name
+     */
+    virtual std::string getName() const = 0;
+
+    /**
+     * @brief Get a short human-readable description of the estimator (e.g., "Critical path")
+     * @return a description
+     */
+    virtual std::string getDescription() const = 0;
+
+    /**
+     * @brief Get the version of the estimator, which is part of the key of cached estimates (and is to be
+     *        changed whenever the estimator's results change)
+     * @return a version
+     */
+    virtual std::string getVersion() const { return "1"; }
+
+    /**
+     * @brief Estimate the makespan of a workflow
+     *
+     * @param summary: the workflow summary
+     * @param config: the platform configuration
+     * @return a makespan in seconds
+     */
+    virtual double estimate(const WorkflowSummary &summary,
+                            const struct platform_config &config) const = 0;
+
+    /**
+     * @brief Estimate the makespan of a workflow for several platform configurations (by default, one
+     *        configuration at a time)
+     *
+     * @param summary: the workflow summary
+     * @param configs: the platform configurations
+     * @param num_threads: the number of threads the estimator may use
+     * @return the makespans, in seconds, in the same order as the configurations
+     */
+    virtual std::vector<double> estimateBatch(const WorkflowSummary &summary,
+                                              const std::vector<struct platform_config> &configs,
+                                              unsigned long num_threads) const;
+};
+
+/**
+ * @brief The signature of the function that an estimator plug-in (a shared object) must export, with
+ *        C linkage, under the name "register_makespan_estimators". It is called when the plug-in is
+ *        loaded, and registers the plug-in's estimators with EstimatorRegistry::registerEstimator().
+ */
+typedef void (*register_makespan_estimators_function)();
+
+/**
+ * @brief A class that keeps track of the available makespan estimators, by name. The built-in estimators
+ *        are "estimate1" (naive, no concurrency), "estimate2" (naive, concurrency), and "estimate3"
+ *        (critical path), and others can be loaded from shared-object plug-ins.
+ */
+class EstimatorRegistry {
+
+public:
+    /**
+     * @brief Register an estimator. As estimator names are result column names, which the accuracy
+     *        evaluator recognizes as estimates, they must start with "estimate" and have no "_" or ",".
+     *
+     * @param estimator: the estimator
+     *
+     * @throw std::invalid_argument if the name is invalid or already registered
+     */
+    static void registerEstimator(const std::shared_ptr<MakespanEstimator> &estimator);
+
+    /**
+     * @brief Load a plug-in, which registers its estimators
+     *
+     * @param path: the path to the plug-in shared object
+     *
+     * @throw std::invalid_argument if the plug-in cannot be loaded
+     */
+    static void loadPlugin(const std::string &path);
+
+    /**
+     * @brief Get an estimator
+     *
+     * @param name: the estimator name
+     * @return the estimator
+     *
+     * @throw std::invalid_argument if there is no such estimator
+     */
+    static std::shared_ptr<MakespanEstimator> getEstimator(const std::string &name);
+
+    /**
+     * @brief Get all estimators
+     * @return the estimators, in registration order (built-in estimators first)
+     */
+    static std::vector<std::shared_ptr<MakespanEstimator>> getEstimators();
+
+private:
+    static std::vector<std::shared_ptr<MakespanEstimator>> &getRegistry();
+};
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_ESTIMATORREGISTRY_H
@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_MAKESPANBOUNDS_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_MAKESPANBOUNDS_H
+
+#include <PlatformSpec.h>
+#include <WorkflowSummary.h>
+
+/**
+ * @brief Lower and upper bounds on the makespan
+ */
+struct makespan_bounds {
+    double lower;
+    double upper;
+};
+
+/**
+ * @brief Compute makespan bounds, in a single pass over tasks (in level, and thus topological, order)
+ *        and their dependencies.
+ *
+ *        The lower bound is the largest of the critical path length (tasks running alone on a node),
+ *        the total compute time divided by the number of cores, and the total I/O time at the aggregate
+ *        bandwidth of all nodes.
+ *
+ *        The upper bound is that of any list schedule (Graham). Task durations are those with the
+ *        largest possible I/O contention, i.e., with all the other cores of the node running tasks.
+ *        Whenever a ready task waits, each node has fewer idle cores than the task needs, so at least
+ *        num_nodes * (num_cores_per_node - c + 1) cores are busy, where c is the largest number of cores
+ *        of a task: the makespan is at most the critical path length plus the total core-time divided by
+ *        that number of cores (Graham's area / P + (1 - 1 / P) * critical path for single-core tasks).
+ *
+ * @param summary: the (non-grouped) workflow summary
+ * @param config: the platform configuration
+ * @return makespan bounds, in seconds
+ *
+ * @throw std::invalid_argument
+ */
+struct makespan_bounds compute_makespan_bounds(const WorkflowSummary &summary,
+                                               const struct platform_config &config);
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_MAKESPANBOUNDS_H
@@ -0,0 +1,213 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_MAKESPANESTIMATORS_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_MAKESPANESTIMATORS_H
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include <PlatformSpec.h>
+#include <WorkflowSummary.h>
+
+/**
+ * @brief Scratch buffers used by the level-by-level estimator. Sized once for the widest
+ *        level of a workflow, so that (re-)estimating makespans never allocates memory.
+ *        A workspace must not be shared between threads.
+ */
+class EstimationWorkspace {
+
+public:
+    explicit EstimationWorkspace(const WorkflowSummary &summary);
+
+    /** @brief Per-task makespans (no contention) for the level being estimated */
+    std::vector<double> keys;
+    /** @brief Task order (offsets in the level) for the level being estimated */
+    std::vector<unsigned long> order;
+    /** @brief Per-task I/O times (no contention), in task order, for the level being estimated */
+    std::vector<double> io_times;
+    /** @brief Per-task compute times, in task order, for the level being estimated */
+    std::vector<double> work_times;
+    /** @brief (task, number of instances) of the phase being packed, with multi-core and overlapped tasks */
+    std::vector<std::pair<unsigned long, unsigned long>> phase_tasks;
+};
+
+/**
+ * @brief The breakdown of a level's critical path estimate over its batches of tasks
+ */
+struct level_profile {
+    /** @brief Number of tasks */
+    unsigned long num_tasks;
+    /** @brief Number of batches (phases, with multi-core tasks) */
+    unsigned long num_batches;
+    /** @brief Makespan, in seconds */
+    double makespan;
+    /** @brief Sum over batches of their average task compute time, in seconds */
+    double compute_time;
+    /** @brief Sum over batches of their average task I/O time (with contention), in seconds */
+    double io_time;
+    /** @brief Fraction of the allocation's cores that run tasks, weighted by batch makespans */
+    double core_utilization;
+    /** @brief Number of idle cores in the last batch */
+    unsigned long idle_cores;
+    /** @brief Largest I/O contention of a batch (see compute_io_contention()) */
+    double io_contention;
+};
+
+/**
+ * @brief Compute the I/O contention of a batch of tasks, i.e., by how much the per-node I/O bandwidths are
+ *        divided: the number of tasks per node, to the power of the configuration's contention exponent
+ *
+ * @param num_tasks: the number of tasks of the batch
+ * @param config: the platform configuration
+ * @return an I/O contention
+ */
+inline double compute_io_contention(unsigned long num_tasks, const struct platform_config &config) {
+    double tasks_per_node = (double)num_tasks / (double)config.num_nodes;
+    return config.io_contention_exponent == 1.0 ? tasks_per_node : std::pow(tasks_per_node, config.io_contention_exponent);
+}
+
+/**
+ * @brief Compute the makespan of a task given the (possibly contended) per-task I/O bandwidths. Without
+ *        overlap, the task reads its inputs, computes, and writes its outputs in sequence; with an overlap
+ *        o, the fraction o of the shorter of its I/O and compute times is hidden behind the longer one
+ *        (o = 1 being a fully pipelined task, whose makespan is the longer of the two).
+ *
+ * @param bytes_read: bytes read by the task
+ * @param bytes_written: bytes written by the task
+ * @param work: work of the task, in units of task execution time
+ * @param config: the platform configuration
+ * @param io_contention: by how much the per-node I/O bandwidths are divided
+ * @param overlap: the task's overlap of I/O and computation, in [0, 1]
+ * @return a makespan in seconds
+ */
+inline double compute_task_makespan(double bytes_read,
+                                    double bytes_written,
+                                    double work,
+                                    const struct platform_config &config,
+                                    double io_contention,
+                                    double overlap = 0.0) {
+    double io_time = io_contention * (bytes_read / config.io_read_speed_per_node + bytes_written / config.io_write_speed_per_node);
+    double compute_time = work * config.task_execution_time;
+    if (overlap > 0.0) {
+        return io_time + compute_time - overlap * std::min<double>(io_time, compute_time);
+    }
+    return io_time + compute_time;
+}
+
+double estimate_makespan_naive_no_overlap(const WorkflowSummary &summary,
+                                          const struct platform_config &config);
+
+double estimate_makespan_naive_overlap(const WorkflowSummary &summary,
+                                       const struct platform_config &config);
+
+/**
+ * @brief Sort the tasks in a level by decreasing makespan (without contention) into workspace.order,
+ *        ties being broken by task order
+ *
+ * @param summary: the workflow summary
+ * @param level: the level
+ * @param config: the platform configuration
+ * @param workspace: the workspace
+ * @param num_threads: the number of threads used to sort (wide levels only)
+ */
+void sort_level_tasks(const WorkflowSummary &summary,
+                      unsigned long level,
+                      const struct platform_config &config,
+                      EstimationWorkspace &workspace,
+                      unsigned long num_threads = 1);
+
+/**
+ * @brief Estimate a level's makespan by sorting its tasks by decreasing makespan into batches of
+ *        num_nodes * num_cores_per_node tasks (non-grouped summaries without multi-core tasks). This is the
+ *        reference for estimate_makespan_level(), which selects the last batch rather than sorting, and
+ *        whose estimates are bitwise identical.
+ *
+ * @param summary: the workflow summary
+ * @param level: the level
+ * @param config: the platform configuration
+ * @param workspace: the workspace
+ * @param num_threads: the number of threads used to sort (wide levels only)
+ * @return a makespan in seconds
+ */
+double estimate_makespan_level_sorted(const WorkflowSummary &summary,
+                                      unsigned long level,
+                                      const struct platform_config &config,
+                                      EstimationWorkspace &workspace,
+                                      unsigned long num_threads = 1);
+
+/**
+ * @brief Estimate a level's makespan. The batches are those of estimate_makespan_level_sorted(), but
+ *        only the tasks of the last, partial, batch are selected (in linear time) rather than sorting
+ *        all tasks. Task makespans are summed in task order in both cases, so that estimates are
+ *        bitwise identical to it.
+ *
+ * @param summary: the workflow summary
+ * @param level: the level
+ * @param config: the platform configuration
+ * @param workspace: the workspace
+ * @param num_threads: the number of threads used to sort (multi-core tasks only)
+ * @return a makespan in seconds
+ */
+double estimate_makespan_level(const WorkflowSummary &summary,
+                               unsigned long level,
+                               const struct platform_config &config,
+                               EstimationWorkspace &workspace,
+                               unsigned long num_threads = 1);
+
+/**
+ * @brief Estimate a level's makespan as estimate_makespan_level() does, and break it down over its batches
+ *
+ * @param summary: the workflow summary
+ * @param level: the level
+ * @param config: the platform configuration
+ * @param workspace: the workspace
+ * @return the level's profile
+ */
+struct level_profile profile_makespan_level(const WorkflowSummary &summary,
+                                            unsigned long level,
+                                            const struct platform_config &config,
+                                            EstimationWorkspace &workspace);
+
+/**
+ * @brief Profile all levels of the critical path estimate (whose makespan is the sum of the level makespans)
+ *
+ * @param summary: the workflow summary
+ * @param config: the platform configuration
+ * @param num_threads: the number of threads (levels are then profiled concurrently)
+ * @return the profile of each level, in level order
+ */
+std::vector<struct level_profile> profile_makespan_critical_path(const WorkflowSummary &summary,
+                                                                 const struct platform_config &config,
+                                                                 unsigned long num_threads = 1);
+
+double estimate_makespan_critical_path(const WorkflowSummary &summary,
+                                       const struct platform_config &config,
+                                       EstimationWorkspace &workspace);
+
+double estimate_makespan_critical_path(const WorkflowSummary &summary,
+                                       const struct platform_config &config);
+
+/**
+ * @brief Compute the critical path estimate with several threads. Wide levels are estimated one at a
+ *        time (with a parallel sort, if their tasks are sorted), and other levels are estimated
+ *        concurrently (each with its own workspace). Level makespans are summed in level order, so that the estimate is bitwise identical
+ *        to that of the serial estimator.
+ *
+ * @param summary: the workflow summary
+ * @param config: the platform configuration
+ * @param num_threads: the number of threads
+ * @return a makespan in seconds
+ */
+double estimate_makespan_critical_path(const WorkflowSummary &summary,
+                                       const struct platform_config &config,
+                                       unsigned long num_threads);
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_MAKESPANESTIMATORS_H
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_MONTECARLOESTIMATOR_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_MONTECARLOESTIMATOR_H
+
+#include <array>
+#include <vector>
+#include <PlatformSpec.h>
+#include <WorkflowSummary.h>
+
+#define NUM_ESTIMATES 3
+
+/**
+ * @brief Parameters of a Monte Carlo uncertainty analysis. The task execution time and the
+ *        per-node I/O bandwidths of a platform come from single measurements, and are thus
+ *        sampled, for each replica, from log-normal distributions whose means are the measured
+ *        values and whose coefficients of variation (stddev / mean) are given here.
+ */
+struct monte_carlo_spec {
+    unsigned long num_replicas;
+    double cv_task_execution_time;
+    double cv_io_read_speed;
+    double cv_io_write_speed;
+    unsigned long num_threads;
+    unsigned long seed;
+};
+
+/**
+ * @brief Percentiles of the distribution of an estimate
+ */
+struct estimate_percentiles {
+    double p50;
+    double p90;
+    double p99;
+};
+
+/**
+ * @brief A class that runs estimator replicas with sampled platform parameters
+ */
+class MonteCarloEstimator {
+
+public:
+
+    /**
+     * @brief Run replicas of the three estimators
+     *
+     * @param summary: the workflow summary
+     * @param config: the (nominal) platform configuration
+     * @param spec: the Monte Carlo parameters
+     * @return the percentiles of each estimate (naive no overlap, naive overlap, critical path)
+     *
+     * @throw std::invalid_argument
+     */
+    static std::array<struct estimate_percentiles, NUM_ESTIMATES> estimate(const WorkflowSummary &summary,
+                                                                           const struct platform_config &config,
+                                                                           const struct monte_carlo_spec &spec);
+
+private:
+    static void runReplicas(const WorkflowSummary &summary,
+                            const struct platform_config &config,
+                            const struct monte_carlo_spec &spec,
+                            unsigned long first_block,
+                            unsigned long last_block,
+                            std::array<std::vector<double>, NUM_ESTIMATES> &results);
+
+    static struct estimate_percentiles computePercentiles(std::vector<double> &values);
+};
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_MONTECARLOESTIMATOR_H
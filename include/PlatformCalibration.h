@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_PLATFORMCALIBRATION_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_PLATFORMCALIBRATION_H
+
+#include <string>
+#include <tuple>
+#include <vector>
+#include <PlatformSpec.h>
+#include <WorkflowSummary.h>
+#include <EstimatorRegistry.h>
+#include <ResultReader.h>
+
+#define NUM_CALIBRATION_PARAMETERS 4
+
+/**
+ * @brief A measured makespan of a workflow on the platform being calibrated
+ */
+struct calibration_observation {
+    /** @brief Index of the workflow's summary */
+    unsigned long workflow;
+    /** @brief Total number of cores of the run */
+    unsigned long num_cores;
+    /** @brief Makespan, in seconds */
+    double makespan;
+};
+
+/**
+ * @brief How a calibration searches for the platform parameters
+ */
+struct calibration_spec {
+    /** @brief Number of starting points: the initial parameters, and random points around them */
+    unsigned long num_starts;
+    /** @brief Spread of the random starting points: the task execution time and bandwidths are multiplied by
+     *         log-uniform factors between 1/spread and spread, and the contention exponent is drawn in [0.5, 1.5] */
+    double spread;
+    /** @brief Maximum number of Levenberg-Marquardt iterations per starting point */
+    unsigned long max_iterations;
+    /** @brief Seed of the random starting points */
+    unsigned long seed;
+    /** @brief Number of threads (starting points are then fitted concurrently) */
+    unsigned long num_threads;
+};
+
+/**
+ * @brief The platform parameters fitted by a calibration
+ */
+struct calibration_result {
+    /** @brief The initial configuration, with the fitted task execution time, per-node read and write
+     *         bandwidths, and I/O contention exponent */
+    struct platform_config config;
+    /** @brief Root mean square of the relative errors of the estimates, with the initial and fitted parameters */
+    double initial_error;
+    double error;
+    /** @brief Largest relative error of the estimates with the fitted parameters */
+    double max_relative_error;
+    /** @brief Index of the starting point of the fitted parameters (0 for the initial parameters) */
+    unsigned long best_start;
+    /** @brief Number of objective evaluations (estimates of all observations) over all starting points */
+    unsigned long num_evaluations;
+};
+
+/**
+ * @brief A class that calibrates a platform from measured makespans: the task execution time, the per-node
+ *        read and write bandwidths, and the I/O contention exponent are fitted so as to minimize the sum of
+ *        the squared relative errors of an estimator's estimates, by Levenberg-Marquardt nonlinear least
+ *        squares (with forward-difference Jacobians, on the logarithms of the time and bandwidths) from
+ *        several starting points. Workflows are summarized once, and all objective evaluations estimate
+ *        the same summaries.
+ */
+class PlatformCalibration {
+
+public:
+    /**
+     * @brief Get the observations of a machine from measured makespans
+     *
+     * @param real: measured makespans (columns app, num_tasks, data_size, type, makespan, machine, and
+     *              optionally num_cores)
+     * @param machine: the machine name
+     * @param type: the task type (e.g., "cpu")
+     * @param labels: the (app, number of tasks, data size) labels of the workflows
+     * @param num_cores: the total number of cores of the runs without a num_cores value
+     * @return the observations of rows of the machine and task type with a workflow and a positive makespan
+     *         (the first workflow with the row's labels)
+     *
+     * @throw std::invalid_argument
+     */
+    static std::vector<struct calibration_observation> getObservations(const struct result_table &real,
+                                                                       const std::string &machine,
+                                                                       const std::string &type,
+                                                                       const std::vector<std::tuple<std::string, long, long>> &labels,
+                                                                       unsigned long num_cores);
+
+    /**
+     * @brief Compute the relative errors of the estimates of observations
+     *
+     * @param summaries: the workflow summaries
+     * @param observations: the observations
+     * @param estimator: the estimator
+     * @param config: the platform configuration (whose number of nodes is that of each observation)
+     * @return the (signed) relative error (estimate - makespan) / makespan of each observation
+     */
+    static std::vector<double> computeRelativeErrors(const std::vector<WorkflowSummary> &summaries,
+                                                     const std::vector<struct calibration_observation> &observations,
+                                                     const MakespanEstimator &estimator,
+                                                     const struct platform_config &config);
+
+    /**
+     * @brief Calibrate a platform
+     *
+     * @param summaries: the workflow summaries
+     * @param observations: the observations
+     * @param estimator: the estimator
+     * @param initial_config: the initial platform configuration
+     * @param spec: the calibration specification
+     * @return the fitted parameters of the starting point with the smallest error (ties broken by
+     *         starting point order, so that results do not depend on the number of threads)
+     *
+     * @throw std::invalid_argument
+     */
+    static struct calibration_result calibrate(const std::vector<WorkflowSummary> &summaries,
+                                               const std::vector<struct calibration_observation> &observations,
+                                               const MakespanEstimator &estimator,
+                                               const struct platform_config &initial_config,
+                                               const struct calibration_spec &spec);
+
+private:
+    static void setParameters(const double *parameters, struct platform_config &config);
+
+    static double fitParameters(const std::vector<WorkflowSummary> &summaries,
+                                const std::vector<struct calibration_observation> &observations,
+                                const MakespanEstimator &estimator,
+                                const struct platform_config &initial_config,
+                                unsigned long max_iterations,
+                                double *parameters,
+                                unsigned long &num_evaluations);
+};
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_PLATFORMCALIBRATION_H
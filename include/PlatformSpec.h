@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_PLATFORMSPEC_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_PLATFORMSPEC_H
+
+#include <map>
+#include <string>
+
+#define GFLOP (1000.0 * 1000.0 * 1000.0)
+#define TFLOP (1000.0 * 1000.0 * 1000.0 * 1000.0)
+#define MBYTE (1000.0 * 1000.0)
+#define GBYTE (1000.0 * 1000.0 * 1000.0)
+
+/**
+ * @brief A platform specification, as measured on a machine with the workflow benchmark
+ */
+struct platform_spec {
+    unsigned num_cores_per_node;
+    double cpu_task_execution_time;
+    double mem_task_execution_time;
+    double io_read_speed_per_node;
+    double io_write_speed_per_node;
+    /** @brief Per-node page cache capacity, in bytes (0 if unknown) */
+    double page_cache_size_per_node;
+    /** @brief Per-node local storage (e.g., NVMe burst buffer) bandwidths (0 if none) */
+    double local_read_speed_per_node;
+    double local_write_speed_per_node;
+    /** @brief Per-node network (NIC) bandwidth, in bytes/sec (0 if there is no network tier) */
+    double network_bandwidth_per_node;
+    /** @brief Network latency, in seconds */
+    double network_latency;
+    /** @brief Bisection bandwidth of the interconnect, in bytes/sec (0 if it does not limit transfers) */
+    double bisection_bandwidth;
+    /** @brief Exponent of the I/O contention: n tasks on a node each get 1/n^exponent of its I/O
+     *         bandwidths (1 for an even share) */
+    double io_contention_exponent = 1.0;
+};
+
+/**
+ * @brief A fully-resolved configuration for which makespans are estimated
+ */
+struct platform_config {
+    unsigned long num_nodes;
+    unsigned long num_cores_per_node;
+    double task_execution_time;
+    double io_read_speed_per_node;
+    double io_write_speed_per_node;
+    double page_cache_size_per_node;
+    double local_read_speed_per_node;
+    double local_write_speed_per_node;
+    double network_bandwidth_per_node;
+    double network_latency;
+    double bisection_bandwidth;
+    double io_contention_exponent = 1.0;
+    /** @brief Parallel fraction of the work of multi-core tasks (Amdahl's law) */
+    double parallel_fraction;
+};
+
+/**
+ * @brief Known platform specifications, indexed by name
+ */
+extern std::map<std::string, struct platform_spec> platform_specs;
+
+/**
+ * @brief Parse a platform specification, which is either a name in platform_specs or
+ *        a "cpu_task_exec_time:mem_task_exec_time:per_node_io_read_bw:per_node_io_write_bw:num_cores_per_nodes[:per_node_page_cache_size[:per_node_local_read_bw:per_node_local_write_bw[:per_node_network_bw:network_latency:bisection_bw[:io_contention_exponent]]]]" string
+ *        (the network latency being in seconds)
+ *
+ * @param spec: the specification string
+ * @return a platform specification
+ *
+ * @throw std::invalid_argument
+ */
+struct platform_spec parse_platform_spec(const std::string &spec);
+
+/**
+ * @brief Build the configuration to use for a given platform, task type execution time, and total core count
+ *
+ * @param spec: the platform specification
+ * @param task_execution_time: the task execution time
+ * @param num_cores: the total number of cores
+ * @return a platform configuration
+ *
+ * @throw std::invalid_argument
+ */
+struct platform_config make_platform_config(const struct platform_spec &spec,
+                                            double task_execution_time,
+                                            unsigned long num_cores);
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_PLATFORMSPEC_H
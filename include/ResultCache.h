@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_RESULTCACHE_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_RESULTCACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @brief A persistent cache of results (e.g., estimates keyed by workflow fingerprint, platform configuration,
+ *        and estimator version), shared by concurrent processes.
+ *
+ *        The cache file is a fixed-size, open-addressing hash table that is memory-mapped, so that lookups
+ *        are O(1) and do not read the file. It is made of:
+ *          - a header: the 8-byte magic "WBMECACH" and a uint64 number of slots
+ *          - slots of three uint64: the 128-bit hash of a key (0 for an empty slot), and an 8-byte value
+ *
+ *        Slots are written once, under an exclusive lock on the file (so that writers are serialized),
+ *        and are published by writing the first word of the key hash last, so that readers do not need
+ *        any lock. When the table is full, new entries are dropped.
+ */
+class ResultCache {
+
+public:
+    /**
+     * @brief Open a cache file, creating it if needed (a file without magic, e.g., left by an interrupted
+     *        initialization, is initialized again)
+     *
+     * @param path: the path to the cache file
+     * @param num_slots: the number of slots of the cache file, if it is created
+     * @return a result cache
+     *
+     * @throw std::invalid_argument
+     */
+    static std::unique_ptr<ResultCache> open(const std::string &path, unsigned long num_slots = 1UL << 20);
+
+    ~ResultCache();
+
+    bool lookup(const std::string &key, uint64_t &value) const;
+    bool lookup(const std::string &key, double &value) const;
+    void insert(const std::string &key, uint64_t value);
+    void insert(const std::string &key, double value);
+
+private:
+    ResultCache() = default;
+
+    uint64_t *findSlot(uint64_t key_low, uint64_t key_high) const;
+
+    int fd = -1;
+    void *mapping = nullptr;
+    unsigned long mapping_size = 0;
+    unsigned long num_slots = 0;
+    uint64_t *slots = nullptr;
+};
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_RESULTCACHE_H
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_RESULTREADER_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_RESULTREADER_H
+
+#include <string>
+#include <vector>
+#include <ResultWriter.h>
+
+/**
+ * @brief A table of results, stored by column. String columns are in strings, and numeric
+ *        (INTEGER or REAL) columns in numbers, in which missing values are NaN.
+ */
+struct result_table {
+    std::vector<struct result_column> schema;
+    std::vector<std::vector<std::string>> strings;
+    std::vector<std::vector<double>> numbers;
+    unsigned long num_rows = 0;
+
+    /**
+     * @brief Find a column by name
+     * @param name: the column name
+     * @return the column index, or -1 if there is no such column
+     */
+    long getColumnIndex(const std::string &name) const {
+        for (unsigned long i = 0; i < schema.size(); i++) {
+            if (schema[i].name == name) {
+                return (long)i;
+            }
+        }
+        return -1;
+    }
+};
+
+/**
+ * @brief A class that reads result files, in any of the formats written by ResultWriter, as well as CSV
+ *        files without type information (e.g., measured makespans) and legacy "CSV," lines
+ */
+class ResultReader {
+
+public:
+    /**
+     * @brief Read a result file
+     *
+     * @param path: the file path
+     * @return a result table
+     *
+     * @throw std::invalid_argument
+     */
+    static struct result_table readResults(const std::string &path);
+
+private:
+    static struct result_table readCsvResults(const std::string &path);
+    static struct result_table readJsonLinesResults(const std::string &path);
+    static struct result_table readBinaryResults(const std::string &path);
+};
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_RESULTREADER_H
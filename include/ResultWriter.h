@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_RESULTWRITER_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_RESULTWRITER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief The type of a result column
+ */
+enum class column_type : uint8_t {
+    STRING = 0,
+    INTEGER = 1,
+    REAL = 2
+};
+
+/**
+ * @brief Convert an unsigned integer between the host byte order and little-endian (the byte order of the
+ *        binary format), which only swaps bytes on big-endian hosts
+ *
+ * @param value: the value
+ * @return the converted value
+ */
+template <class T>
+inline T convert_little_endian(T value) {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    if constexpr (sizeof(T) == 8) {
+        return (T)__builtin_bswap64(value);
+    } else if constexpr (sizeof(T) == 4) {
+        return (T)__builtin_bswap32(value);
+    } else if constexpr (sizeof(T) == 2) {
+        return (T)__builtin_bswap16(value);
+    }
+#endif
+    return value;
+}
+
+/**
+ * @brief A result column (name and type)
+ */
+struct result_column {
+    std::string name;
+    column_type type;
+};
+
+/**
+ * @brief A class that streams result rows, with an explicit schema, to a file (or to stdout). Rows
+ *        are built by adding one value per column, in schema order, and then calling endRow().
+ *        Output is buffered and written in large chunks.
+ *
+ *        Supported formats:
+ *          - "csv": a header line with column names, then one line per row
+ *          - "jsonl": one JSON object per row
+ *          - "binary": a columnar format, made of:
+ *               - a header: the 8-byte magic "WBMECOL1", a uint32 number of columns, and for each
+ *                 column a uint8 type (see column_type), a uint32 name length, and the name bytes
+ *               - row groups, until the end of the file: a uint64 number of rows n, then for each
+ *                 column: n int64 (INTEGER), n float64 (REAL), or a uint64 number of bytes m, n uint64
+ *                 end offsets, and m bytes (STRING)
+ *            All numbers are little-endian (bytes are swapped on big-endian hosts).
+ */
+class ResultWriter {
+
+public:
+
+    /**
+     * @brief Create a result writer
+     *
+     * @param format: "csv", "jsonl", or "binary"
+     * @param path: the output file path ("-" for stdout)
+     * @param schema: the result columns
+     * @return a result writer
+     *
+     * @throw std::invalid_argument
+     */
+    static std::unique_ptr<ResultWriter> createResultWriter(const std::string &format,
+                                                            const std::string &path,
+                                                            const std::vector<struct result_column> &schema);
+
+    virtual ~ResultWriter();
+
+    void addString(std::string_view value);
+    void addInteger(int64_t value);
+    void addReal(double value);
+    void endRow();
+    void close();
+
+    /** @brief The result columns */
+    const std::vector<struct result_column> &getSchema() const { return schema; }
+
+protected:
+    ResultWriter(const std::string &path, const std::vector<struct result_column> &schema);
+
+    virtual void writeString(std::string_view value) = 0;
+    virtual void writeInteger(int64_t value) = 0;
+    virtual void writeReal(double value) = 0;
+    virtual void writeEndRow() = 0;
+    virtual void writeEnd() {}
+
+    void append(std::string_view bytes);
+    void flushBuffer();
+
+    std::vector<struct result_column> schema;
+    std::string buffer;
+    unsigned long current_column = 0;
+
+private:
+    void checkColumn(column_type type);
+
+    FILE *file = nullptr;
+    bool closed = false;
+};
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_RESULTWRITER_H
@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_SENSITIVITYANALYSIS_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_SENSITIVITYANALYSIS_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include <PlatformSpec.h>
+#include <WorkflowSummary.h>
+
+#define NUM_SENSITIVITY_PARAMETERS 4
+
+/**
+ * @brief The platform parameters of a sensitivity analysis
+ */
+enum sensitivity_parameter {
+    TASK_EXECUTION_TIME = 0,
+    IO_READ_SPEED = 1,
+    IO_WRITE_SPEED = 2,
+    NUM_CORES = 3
+};
+
+/**
+ * @brief The sensitivity of a makespan to the platform parameters
+ */
+struct makespan_sensitivity {
+    /** @brief Makespan, in seconds */
+    double makespan;
+    /** @brief Elasticities (relative change of the makespan per relative change of the parameter), indexed by
+     *         sensitivity_parameter: e.g., -0.8 for a bandwidth means that 1% more bandwidth makes the
+     *         makespan 0.8% shorter */
+    std::array<double, NUM_SENSITIVITY_PARAMETERS> elasticities;
+};
+
+/**
+ * @brief A class that computes the elasticities of makespan estimates with respect to the task execution time,
+ *        the per-node read and write bandwidths, and the number of cores, by central differences: each
+ *        parameter is perturbed up and down (by a relative step, or by one node for the number of cores), and
+ *        all perturbed configurations are estimated together on the same workflow summary.
+ */
+class SensitivityAnalysis {
+
+public:
+    /**
+     * @brief Get the perturbed configurations of a configuration
+     *
+     * @param config: the platform configuration
+     * @param relative_step: the relative perturbation of the task execution time and bandwidths
+     * @return 2 * NUM_SENSITIVITY_PARAMETERS configurations: for each parameter, the configuration with the
+     *         parameter increased, and then decreased (the number of nodes is not decreased below 1)
+     *
+     * @throw std::invalid_argument
+     */
+    static std::vector<struct platform_config> getPerturbedConfigs(const struct platform_config &config,
+                                                                   double relative_step);
+
+    /**
+     * @brief Compute the sensitivity of a makespan from the makespans of the perturbed configurations
+     *
+     * @param config: the platform configuration
+     * @param relative_step: the relative perturbation
+     * @param makespan: the makespan for the configuration
+     * @param perturbed_makespans: the makespans for the perturbed configurations (see getPerturbedConfigs())
+     * @return a makespan sensitivity
+     */
+    static struct makespan_sensitivity computeSensitivity(const struct platform_config &config,
+                                                          double relative_step,
+                                                          double makespan,
+                                                          const double *perturbed_makespans);
+
+    /**
+     * @brief Compute the sensitivity of the critical path estimate of each level (all perturbed configurations
+     *        of a level being estimated one after the other, with the same workspace)
+     *
+     * @param summary: the workflow summary
+     * @param config: the platform configuration
+     * @param relative_step: the relative perturbation
+     * @param num_threads: the number of threads (levels are then analyzed concurrently)
+     * @return the sensitivity of each level's makespan, in level order
+     *
+     * @throw std::invalid_argument
+     */
+    static std::vector<struct makespan_sensitivity> analyzeLevels(const WorkflowSummary &summary,
+                                                                  const struct platform_config &config,
+                                                                  double relative_step,
+                                                                  unsigned long num_threads);
+
+    /**
+     * @brief Rank the parameters of a sensitivity, most limiting first
+     *
+     * @param sensitivity: the makespan sensitivity
+     * @return the parameters, by decreasing absolute elasticity (ties broken by parameter order)
+     */
+    static std::array<enum sensitivity_parameter, NUM_SENSITIVITY_PARAMETERS> rankParameters(
+            const struct makespan_sensitivity &sensitivity);
+
+    /**
+     * @brief Get the short name of a parameter
+     * @param parameter: the parameter
+     * @return a name ("cpu", "read", "write", or "cores")
+     */
+    static std::string getParameterName(enum sensitivity_parameter parameter);
+};
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_SENSITIVITYANALYSIS_H
@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_SIMULATIONFARM_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_SIMULATIONFARM_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <wrench-dev.h>
+#include <PlatformSpec.h>
+
+/**
+ * @brief The result of a simulation
+ */
+struct simulation_result {
+    /** @brief Simulated makespan, in seconds (negative if the simulation failed) */
+    double makespan;
+    /** @brief Wall-clock time of the simulation, in seconds */
+    double wall_time;
+};
+
+/**
+ * @brief A class that runs full WRENCH simulations of a workflow for many platform configurations.
+ *
+ *        As SimGrid can only run one simulation per process, each simulation is run in a worker process
+ *        forked from the calling process, which inherits the (already parsed and built) workflow copy-on-write,
+ *        and sends its result back over a pipe. The simulated platform has one host per node (with the
+ *        configuration's cores, and a speed such that a task of one unit of work takes the task execution
+ *        time), each connected by a link at the per-node I/O bandwidth to a storage host whose disk has the
+ *        aggregate bandwidths of all nodes, and that holds all files.
+ */
+class SimulationFarm {
+
+public:
+    /**
+     * @brief Simulate a workflow for several platform configurations
+     *
+     * @param simulation: the (initialized, but not launched) simulation
+     * @param workflow: the workflow, whose tasks have one flop per unit of work
+     * @param configs: the platform configurations
+     * @param num_workers: the maximum number of worker processes running at once
+     * @param callback: the function called (in the calling process) with the index of the configuration and
+     *                  its result as each simulation completes
+     * @return the results, in the same order as the configurations
+     *
+     * @throw std::invalid_argument
+     */
+    static std::vector<struct simulation_result> simulate(
+            const std::shared_ptr<wrench::Simulation> &simulation,
+            const std::shared_ptr<wrench::Workflow> &workflow,
+            const std::vector<struct platform_config> &configs,
+            unsigned long num_workers,
+            const std::function<void(unsigned long, const struct simulation_result &)> &callback = nullptr);
+
+private:
+    static std::string createPlatformFile(const struct platform_config &config);
+    static double simulateOne(const std::shared_ptr<wrench::Simulation> &simulation,
+                              const std::shared_ptr<wrench::Workflow> &workflow,
+                              const struct platform_config &config);
+};
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_SIMULATIONFARM_H
@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_STREAMINGWORKFLOWREADER_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_STREAMINGWORKFLOWREADER_H
+
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <WorkflowFingerprint.h>
+#include <WorkflowSummary.h>
+
+/**
+ * @brief A class that reads a WfCommons JSON workflow file without ever holding the whole workflow in memory,
+ *        for workflows too large to be loaded as a wrench::Workflow (and a JSON DOM).
+ *
+ *        The first pass parses the file one task at a time, spilling a record per task (name, data sizes, cores,
+ *        category) and a compact (parent name hash, child) dependency stream to disk, and then computes task
+ *        levels (longest path from an entry task, i.e., WRENCH's top levels) from the dependency stream. Further
+ *        passes (see forEachLevel()) stream the task records back, grouped by level, as single-level workflow
+ *        summaries that are identical to the corresponding level of WorkflowSummary::createFromWorkflow(), so
+ *        that level-by-level estimates are those of the in-memory path.
+ *
+ *        Memory is not bounded by the widest level: computing levels takes O(V + E) memory (about 48 bytes per
+ *        task for name hashes, the hash index, levels and parent counts, and 8 bytes per dependency), and
+ *        per-task levels (8 bytes per task) are then kept for the further passes, which also hold up to
+ *        memory_budget bytes of task records.
+ *
+ *        Task names are identified by their 64-bit hash in the dependency stream: a hash collision (or a
+ *        duplicate task name) is detected, and reported as an error.
+ */
+class StreamingWorkflowReader {
+
+public:
+
+    /**
+     * @brief Run the first pass over a workflow file
+     *
+     * @param filename: the path to the JSON file
+     * @param spill_directory: the directory of the (temporary) spill files
+     * @param memory_budget: the amount of task records streamed back at once, in bytes (at least a level's worth)
+     * @return a streaming workflow reader
+     *
+     * @throw std::invalid_argument
+     */
+    static std::unique_ptr<StreamingWorkflowReader> createFromJSON(const std::string &filename,
+                                                                   const std::string &spill_directory,
+                                                                   unsigned long memory_budget = 1024UL * 1024 * 1024);
+
+    ~StreamingWorkflowReader();
+
+    /**
+     * @brief Stream the workflow's levels, in level order
+     *
+     * @param callback: the function called with a (non-grouped) single-level summary of each level, whose
+     *                  max_task_cores is that of the whole workflow (category names are those of getTotals())
+     *
+     * @throw std::invalid_argument
+     */
+    void forEachLevel(const std::function<void(const WorkflowSummary &)> &callback) const;
+
+    /**
+     * @brief Get a summary of the workflow that only has its totals (number of tasks, total work and data sizes,
+     *        largest number of cores and level width), enough for the naive estimators
+     * @return a workflow summary without per-task data
+     */
+    const WorkflowSummary &getTotals() const { return totals; }
+
+    /** @brief Fingerprint of the workflow */
+    const WorkflowFingerprint &getFingerprint() const { return fingerprint; }
+
+    /** @brief Number of tasks */
+    unsigned long getNumTasks() const { return levels.size(); }
+
+    /** @brief Number of dependencies (as listed in the file) */
+    unsigned long getNumDependencies() const { return num_dependencies; }
+
+    /** @brief Number of levels */
+    unsigned long getNumLevels() const { return level_widths.size(); }
+
+private:
+    StreamingWorkflowReader() = default;
+
+    void computeLevels(const std::vector<uint64_t> &name_hashes, unsigned long num_dependencies);
+
+    /** @brief The spill files (task records, and (parent name hash, child) dependencies) */
+    std::string task_file_path;
+    std::string dependency_file_path;
+    /** @brief Per-task level, in file order */
+    std::vector<unsigned long> levels;
+    /** @brief Per-level number of tasks */
+    std::vector<unsigned long> level_widths;
+    unsigned long num_dependencies = 0;
+    unsigned long memory_budget = 0;
+    WorkflowSummary totals;
+    WorkflowFingerprint fingerprint;
+};
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_STREAMINGWORKFLOWREADER_H
@@ -0,0 +1,42 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_TRANSITIVEREDUCTION_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_TRANSITIVEREDUCTION_H
+
+#include <vector>
+
+/**
+ * @brief A class that computes the transitive reduction of a DAG given as per-node parent lists
+ *
+ *        An edge p->v can only be redundant if it skips at least one level (the level of a node being
+ *        the length of the longest path from an entry node to it). The sources of such "candidate" edges are the only nodes whose descendants need to be
+ *        known, and they are tracked as bitsets of (candidate source) ancestors, computed level by level,
+ *        with the nodes of a level processed in parallel. When these bitsets would not fit in the memory
+ *        budget, candidate sources are processed in chunks.
+ */
+class TransitiveReduction {
+
+public:
+    /**
+     * @brief Remove duplicate and redundant edges from a DAG
+     *
+     * @param parents: the parents of each node (modified in place)
+     * @param num_threads: the number of threads to use
+     * @param memory_budget: the maximum size of ancestor bitsets, in bytes
+     * @return the number of removed edges
+     *
+     * @throw std::invalid_argument if the graph has a cycle
+     */
+    static unsigned long reduce(std::vector<std::vector<unsigned long>> &parents,
+                                unsigned long num_threads,
+                                unsigned long memory_budget = 256UL * 1024 * 1024);
+};
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_TRANSITIVEREDUCTION_H
@@ -9,14 +9,13 @@
 
 
 
-#include <unordered_map>
+#include <array>
+#include <string_view>
 
 /***********************/
 /** \cond INTERNAL     */
 /***********************/
 
-class unit_scale;
-
 /**
  * @brief A class used to part string specification of values with units into
  *        a single value (e.g., "2KB" -> 2048 bytes, "2Kb" -> 256 bytes)
@@ -24,23 +23,28 @@ class unit_scale;
 class UnitParser {
 
     /**
-     * @brief A helper nested class to facilitate unit conversion
+     * @brief A helper nested class to facilitate unit conversion: a base unit (e.g., "B") and its
+     *        value scaled by each prefix (no prefix, then "k" to "Y", then "Ki" to "Yi"),
+     *        computed at compile time. Prefixes are looked up by their first letter.
      * (Essentially Cut-And-Pasted from simgrid/src/surf/xml/surfxml_sax_cb.cpp)
      */
-    class unit_scale : public std::unordered_map<std::string, double> {
-    public:
-        using std::unordered_map<std::string, double>::unordered_map;
-        // tuples are : <unit, value for unit, base (2 or 10), true if abbreviated>
-        explicit unit_scale(std::initializer_list<std::tuple<const std::string, double, int, bool>> generators);
+    struct unit_scale {
+        std::string_view unit;
+        std::array<double, 17> values;
+        bool binary;
+
+        constexpr unit_scale(std::string_view unit, double value, bool binary);
     };
 
 private:
-    static double parseValueWithUnit(std::string string, const unit_scale &units, const char *default_unit);
+    static int prefixIndex(std::string_view prefix);
+    template <std::size_t N>
+    static double parseValueWithUnit(std::string_view string, const std::array<unit_scale, N> &units, std::string_view default_unit);
 
 public:
-    static double parse_size(std::string string);
-    static double parse_compute_speed(std::string string);
-    static double parse_bandwidth(std::string string);
+    static double parse_size(std::string_view string);
+    static double parse_compute_speed(std::string_view string);
+    static double parse_bandwidth(std::string_view string);
 
 
 };
@@ -48,5 +52,3 @@ public:
 /***********************/
 /** \endcond           */
 /***********************/
-
-
@@ -10,6 +10,9 @@
 #include <wrench-dev.h>
 #include <string>
 #include <memory>
+#include <unordered_map>
+#include <WorkflowSummary.h>
+#include <WorkflowFingerprint.h>
 
 
     class Workflow;
@@ -32,15 +35,26 @@
          *                             other control/data dependencies (i.e., they correspond to transitive
          *                             closures or existing edges in the workflow graphs). Passing redundant_dependencies=true
          *                             force these "redundant" dependencies to be added as edges in the workflow. Passing
-         *                             redundant_dependencies=false will ignore these "redundant" dependencies. Most users
+         *                             redundant_dependencies=false will ignore these "redundant" dependencies, which are
+         *                             removed by a transitive reduction pass before edges are added. Most users
          *                             would likely pass "false".
+         * @param task_attributes: if not nullptr, filled with the attributes of each task (by task ID)
+         * @param fingerprint: if not nullptr, the fingerprint to which the workflow's tasks are added
+         * @param file_id_prefix: a prefix of the IDs of the workflow's files, as WRENCH files are shared by all
+         *                        workflows (e.g., so that workflows loaded together have distinct files)
+         * @param num_removed_dependencies: if not nullptr, set to the number of redundant dependencies that were
+         *                                  removed (0 if redundant_dependencies is true)
          * @return a workflow
          * @throw std::invalid_argument
          *
          */
         static std::shared_ptr<wrench::Workflow> createWorkflowFromJSON(const std::string &filename,
                                                                         double flops_per_unit_of_cpu_work,
-                                                                        bool redundant_dependencies);
+                                                                        bool redundant_dependencies,
+                                                                        std::unordered_map<std::string, struct task_attributes> *task_attributes = nullptr,
+                                                                        WorkflowFingerprint *fingerprint = nullptr,
+                                                                        const std::string &file_id_prefix = "",
+                                                                        unsigned long *num_removed_dependencies = nullptr);
 
     };
 
@@ -0,0 +1,49 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_WORKFLOWFINGERPRINT_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_WORKFLOWFINGERPRINT_H
+
+#include <cstdint>
+#include <string>
+#include <nlohmann/json_fwd.hpp>
+
+/**
+ * @brief A 128-bit content hash of the structure of a workflow (task names, cores, categories, commands,
+ *        files, and dependencies), accumulated task by task while the workflow file is parsed. Task hashes
+ *        are added up, so that the fingerprint does not depend on the order of tasks in the file.
+ */
+class WorkflowFingerprint {
+
+public:
+    /**
+     * @brief Add a task to the fingerprint
+     * @param job: the task, as a WfCommons JSON object
+     */
+    void addTask(const nlohmann::json &job);
+
+    /**
+     * @brief Get the fingerprint as a string
+     * @return 32 hexadecimal digits
+     */
+    std::string toString() const;
+
+    /**
+     * @brief A (stable across runs and builds) 64-bit hash of a byte string
+     * @param bytes: the byte string
+     * @param seed: the seed (different seeds give independent hashes)
+     * @return a hash
+     */
+    static uint64_t hash(const std::string &bytes, uint64_t seed);
+
+    uint64_t low = 0;
+    uint64_t high = 0;
+};
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_WORKFLOWFINGERPRINT_H
@@ -0,0 +1,211 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_WORKFLOWSUMMARY_H
+#define WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_WORKFLOWSUMMARY_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <PlatformSpec.h>
+
+namespace wrench {
+    class Workflow;
+}
+
+/**
+ * @brief Per-task attributes that WRENCH tasks do not store, as read by WfCommonsWorkflowParser
+ */
+struct task_attributes {
+    /** @brief Task category (e.g., "blastall") */
+    std::string category;
+    /** @brief Fraction of the task's compute time that is CPU-bound (the --percent-cpu argument of wfbench tasks) */
+    double percent_cpu = 1.0;
+};
+
+/**
+ * @brief A compact, structure-of-arrays view of the per-task data that the estimators need. It
+ *        is computed once per workflow, and is then shared (read-only) by all estimates, so that
+ *        estimates never go back to the wrench::Workflow object.
+ *
+ *        Tasks are stored grouped by top level: the tasks in level l are at indices
+ *        level_offsets[l] (included) to level_offsets[l+1] (excluded).
+ *
+ *        In a grouped summary (see createGrouped()), each entry stands for multiplicity[i] identical
+ *        tasks of a same level, so that estimators walk groups of tasks rather than tasks.
+ */
+class WorkflowSummary {
+
+public:
+
+    /**
+     * @brief Create a summary of a workflow
+     *
+     * @param workflow: the workflow (with task flops set to the task's amount of work, in units of
+     *                  task execution time)
+     * @param attributes: per-task attributes, by task ID (nullptr if none)
+     * @param category_overlaps: per-category overlap factors, "*" standing for other categories (nullptr if
+     *                           tasks do not overlap I/O and computation). A task's overlap is the factor of
+     *                           its category times its CPU-bound fraction (see struct task_attributes).
+     * @return a workflow summary
+     */
+    static WorkflowSummary createFromWorkflow(const std::shared_ptr<wrench::Workflow> &workflow,
+                                              const std::unordered_map<std::string, struct task_attributes> *attributes = nullptr,
+                                              const std::unordered_map<std::string, double> *category_overlaps = nullptr);
+
+    /**
+     * @brief Create a grouped summary, in which the tasks of each level that have the same category,
+     *        work, bytes read and written, number of cores, and overlap are a single entry
+     *
+     * @param summary: a (non-grouped) workflow summary
+     * @return a grouped workflow summary
+     */
+    static WorkflowSummary createGrouped(const WorkflowSummary &summary);
+
+    /**
+     * @brief Create a summary in which bytes read account for per-node page caches. An input file read by
+     *        c tasks of a same level is only read from the file system once per node, i.e., min(c, num_nodes)
+     *        times, provided it fits in the page cache. When the shared input files of a level do not all
+     *        fit, those that save the most file system reads per cached byte are cached first.
+     *
+     * @param summary: a (non-grouped) workflow summary
+     * @param num_nodes: the number of nodes
+     * @param page_cache_size: the per-node page cache capacity, in bytes
+     * @return a workflow summary
+     *
+     * @throw std::invalid_argument
+     */
+    static WorkflowSummary createWithPageCache(const WorkflowSummary &summary,
+                                               unsigned long num_nodes,
+                                               double page_cache_size);
+
+    /**
+     * @brief Create a summary in which intermediate files (produced and consumed by tasks of the workflow) are
+     *        staged on node-local storage, i.e., read and written at the per-node local bandwidths of the
+     *        configuration, whereas workflow inputs and outputs are read/written at the file system bandwidths.
+     *        Intermediate bytes are converted to the number of file system bytes that take as long to transfer,
+     *        so that estimators need no change. Configurations without local storage leave the summary unchanged.
+     *
+     * @param summary: a workflow summary
+     * @param config: the platform configuration (only bandwidths matter)
+     * @return a workflow summary
+     */
+    static WorkflowSummary createWithStaging(const WorkflowSummary &summary,
+                                             const struct platform_config &config);
+
+    /**
+     * @brief Create a summary in which intermediate files stay on the node of the task that produced them:
+     *        tasks are placed on the nodes, level by level, each one on the node of the producer it reads the
+     *        most bytes from (within a balanced number of tasks per node), and files read by a task on another
+     *        node are transferred over the network (at the per-node network bandwidth, or the node's share of
+     *        the bisection bandwidth, with one latency per producer), whereas other intermediate files are
+     *        read and written at the per-node local bandwidths (the file system bandwidths, without local
+     *        storage). As with staging, intermediate bytes are converted to the number of file system bytes
+     *        that take as long to transfer. Configurations without a network tier leave the summary unchanged.
+     *
+     * @param summary: a (non-grouped) workflow summary
+     * @param config: the platform configuration
+     * @return a workflow summary
+     *
+     * @throw std::invalid_argument
+     */
+    static WorkflowSummary createWithNetwork(const WorkflowSummary &summary,
+                                             const struct platform_config &config);
+
+    /**
+     * @brief Create the summary of an ensemble of workflows that run concurrently, i.e., of the disjoint
+     *        union of their graphs: level l of the ensemble is made of the tasks of level l of all
+     *        workflows (in workflow order), whose member is the workflow's index
+     *
+     * @param summaries: the (non-grouped) workflow summaries (whose files must be distinct)
+     * @return a workflow summary
+     *
+     * @throw std::invalid_argument
+     */
+    static WorkflowSummary createUnion(const std::vector<WorkflowSummary> &summaries);
+
+    /** @brief Number of tasks */
+    unsigned long getNumTasks() const { return num_tasks; }
+    /** @brief Number of levels */
+    unsigned long getNumLevels() const { return level_offsets.empty() ? 0 : level_offsets.size() - 1; }
+    /** @brief Number of entries (tasks, or groups of tasks) in a level */
+    unsigned long getLevelWidth(unsigned long level) const { return level_offsets[level + 1] - level_offsets[level]; }
+    /** @brief Whether some tasks need more than one core */
+    bool hasMultiCoreTasks() const { return max_task_cores > 1; }
+    /** @brief Whether entries are groups of tasks */
+    bool isGrouped() const { return not multiplicity.empty(); }
+    /** @brief Whether some tasks overlap their I/O and computation */
+    bool hasOverlap() const { return not overlap.empty(); }
+    /** @brief Whether the summary is that of an ensemble of workflows */
+    bool isEnsemble() const { return not member.empty(); }
+
+    /** @brief Per-task amount of work, in units of task execution time */
+    std::vector<double> work;
+    /** @brief Per-task number of bytes read */
+    std::vector<double> bytes_read;
+    /** @brief Per-task number of bytes written */
+    std::vector<double> bytes_written;
+    /** @brief Per-task number of bytes read from/written to intermediate files (included in bytes_read/bytes_written) */
+    std::vector<double> intermediate_bytes_read;
+    std::vector<double> intermediate_bytes_written;
+    /** @brief Per-task number of cores (the task's minimum number of cores) */
+    std::vector<unsigned long> num_cores;
+    /** @brief Per-task fraction of the shorter of its I/O and compute times that is overlapped with the
+     *         longer one, in [0, 1] (empty if no task overlaps them) */
+    std::vector<double> overlap;
+    /** @brief Per-task category, as an index in categories */
+    std::vector<unsigned long> category;
+    /** @brief Per-task number of tasks (grouped summaries only, empty otherwise) */
+    std::vector<unsigned long> multiplicity;
+    /** @brief Per-task index of the task's workflow in an ensemble (ensemble summaries only, empty otherwise) */
+    std::vector<unsigned long> member;
+    /** @brief Number of workflows in an ensemble (0 if the summary is not that of an ensemble) */
+    unsigned long num_members = 0;
+    /** @brief Input files of each task that other tasks of its level also read (non-grouped summaries only):
+     *         those of task t are at indices shared_input_offsets[t] (included) to shared_input_offsets[t+1]
+     *         (excluded) of shared_inputs (file indices) and shared_input_consumers (number of tasks of
+     *         the level that read the file) */
+    std::vector<unsigned long> shared_input_offsets;
+    std::vector<unsigned long> shared_inputs;
+    std::vector<unsigned long> shared_input_consumers;
+    /** @brief Parents of each task (non-grouped summaries only): those of task t are at indices
+     *         parent_offsets[t] (included) to parent_offsets[t+1] (excluded) of parents */
+    std::vector<unsigned long> parent_offsets;
+    std::vector<unsigned long> parents;
+    /** @brief Data dependencies of each task (non-grouped summaries only): the tasks that produce the files
+     *         that task t reads are at indices producer_offsets[t] (included) to producer_offsets[t+1]
+     *         (excluded) of producers, and producer_bytes are the numbers of bytes that t reads from them */
+    std::vector<unsigned long> producer_offsets;
+    std::vector<unsigned long> producers;
+    std::vector<double> producer_bytes;
+    /** @brief Per-file size, in bytes */
+    std::vector<double> file_sizes;
+    /** @brief Per-file producing task (-1 for workflow inputs) */
+    std::vector<long> file_producers;
+    /** @brief Level boundaries (getNumLevels() + 1 entries) */
+    std::vector<unsigned long> level_offsets;
+    /** @brief Category names */
+    std::vector<std::string> categories;
+
+    /** @brief Number of tasks */
+    unsigned long num_tasks = 0;
+    /** @brief Sum of all task work */
+    double total_work = 0.0;
+    /** @brief Sum of all bytes read */
+    double total_bytes_read = 0.0;
+    /** @brief Sum of all bytes written */
+    double total_bytes_written = 0.0;
+    /** @brief Largest per-task number of cores */
+    unsigned long max_task_cores = 1;
+    /** @brief Number of entries in the widest level */
+    unsigned long max_level_width = 0;
+};
+
+#endif //WORKFLOW_BENCHMARK_MAKESPAN_ESTIMATOR_WORKFLOWSUMMARY_H
@@ -3,6 +3,9 @@ import sys
 import matplotlib.pyplot as plt
 from matplotlib.pyplot import figure
 import itertools
+import csv
+import json
+import struct
 
 db = []
 l_machine = []
@@ -10,6 +13,72 @@ l_app = []
 l_num_tasks = []
 l_data_size = []
 l_type = []
+l_estimator = []
+
+
+##
+# Read a columnar binary result file written by the estimator (format documented in include/ResultWriter.h)
+def read_binary_results(model_results_file):
+    with open(model_results_file, "rb") as f:
+        data = f.read()
+    if data[0:8] != b"WBMECOL1":
+        raise ValueError("Not a binary result file: " + model_results_file)
+    offset = 8
+    [num_columns] = struct.unpack_from("<I", data, offset)
+    offset += 4
+    columns = []
+    for i in range(0, num_columns):
+        [column_type, name_length] = struct.unpack_from("<BI", data, offset)
+        offset += 5
+        columns.append((data[offset:offset + name_length].decode(), column_type))
+        offset += name_length
+    rows = []
+    while offset < len(data):
+        [num_rows] = struct.unpack_from("<Q", data, offset)
+        offset += 8
+        group = [{} for i in range(0, num_rows)]
+        for (name, column_type) in columns:
+            if column_type == 0:
+                [num_bytes] = struct.unpack_from("<Q", data, offset)
+                offset += 8
+                ends = struct.unpack_from("<" + str(num_rows) + "Q", data, offset)
+                offset += 8 * num_rows
+                start = 0
+                for i in range(0, num_rows):
+                    group[i][name] = data[offset + start:offset + ends[i]].decode()
+                    start = ends[i]
+                offset += num_bytes
+            else:
+                values = struct.unpack_from("<" + str(num_rows) + ("q" if column_type == 1 else "d"), data, offset)
+                offset += 8 * num_rows
+                for i in range(0, num_rows):
+                    group[i][name] = values[i]
+        rows += group
+    return rows
+
+
+##
+# Read a model result file written by the estimator, in any of its output formats (or
+# made of legacy "CSV," lines)
+def read_model_results(model_results_file):
+    with open(model_results_file, "rb") as f:
+        magic = f.read(8)
+    if magic == b"WBMECOL1":
+        return read_binary_results(model_results_file)
+    with open(model_results_file) as f:
+        lines = [line for line in f.readlines() if line.strip() != ""]
+    if len(lines) > 0 and lines[0].startswith("{"):
+        return [json.loads(line) for line in lines]
+    if len(lines) > 0 and lines[0].startswith("app,"):
+        return list(csv.DictReader(lines))
+    rows = []
+    for line in lines:
+        if line.startswith("CSV,"):
+            line = line[4:]
+        tokens = line.strip().split(",")
+        rows.append({"app": tokens[0], "num_tasks": tokens[1], "data_size": tokens[2], "type": tokens[3],
+                     "estimate1": tokens[4], "estimate2": tokens[5], "estimate3": tokens[6], "machine": tokens[7]})
+    return rows
 
 
 ##
@@ -21,12 +90,16 @@ def construct_db(real_results_file, model_results_file):
     global l_num_tasks
     global l_data_size
     global l_type
+    global l_estimator
 
     with open(real_results_file) as f:
         real_lines = f.readlines()
 
-    with open(model_results_file) as f:
-        model_lines = f.readlines()
+    model_rows = read_model_results(model_results_file)
+
+    # Estimate columns (those of estimators, not of their Monte Carlo percentiles)
+    if len(model_rows) > 0:
+        l_estimator = [k for k in model_rows[0].keys() if k.startswith("estimate") and "_" not in k]
 
     # Build dictionary of results
     for line in real_lines:
@@ -41,10 +114,9 @@ def construct_db(real_results_file, model_results_file):
                 "data_size": int(tokens[2]),
                 "type": tokens[3],
                 "machine": tokens[5],
-                "real": float(tokens[4]),
-                "estimate1": 0.0,
-                "estimate2": 0.0,
-                "estimate3": 0.0}
+                "real": float(tokens[4])}
+        for e in l_estimator:
+            data[e] = 0.0
 
         db.append(data)
         l_machine.append(data["machine"])
@@ -59,16 +131,14 @@ def construct_db(real_results_file, model_results_file):
     l_data_size = list(set(l_data_size))
     l_type = list(set(l_type))
 
-    for line in model_lines:
-        tokens = line.strip().split(",")
-        data = {"app": tokens[0],
-                "num_tasks": int(tokens[1]),
-                "data_size": int(tokens[2]),
-                "type": tokens[3],
-                "estimate1": float(tokens[4]),
-                "estimate2": float(tokens[5]),
-                "estimate3": float(tokens[6]),
-                "machine": tokens[7]}
+    for row in model_rows:
+        data = {"app": row["app"],
+                "num_tasks": int(row["num_tasks"]),
+                "data_size": int(row["data_size"]),
+                "type": row["type"],
+                "machine": row["machine"]}
+        for e in l_estimator:
+            data[e] = float(row[e])
 
         keys = ["app", "num_tasks", "data_size", "type", "machine"]
         for i in range(0, len(db)):
@@ -78,9 +148,8 @@ def construct_db(real_results_file, model_results_file):
                     to_update = False
                     break
             if to_update:
-                db[i]["estimate1"] = data["estimate1"]
-                db[i]["estimate2"] = data["estimate2"]
-                db[i]["estimate3"] = data["estimate3"]
+                for e in l_estimator:
+                    db[i][e] = data[e]
                 break
 
     # # remove incomplete entries
@@ -100,7 +169,7 @@ def get_results(query):
                 match = False
                 break
         if match:
-            return [data["real"], data["estimate1"], data["estimate2"], data["estimate3"]]
+            return [data["real"]] + [data[e] for e in l_estimator]
     raise "Oh no!"
 
 
@@ -108,12 +177,8 @@ def print_ranking_mistakes():
 
     machine_pairs = list(itertools.combinations(l_machine, 2))
 
-    estimate1_wrong = 0
-    estimate2_wrong = 0
-    estimate3_wrong = 0
-    estimate1_right = 0
-    estimate2_right = 0
-    estimate3_right = 0
+    wrong = {e: 0 for e in l_estimator}
+    right = {e: 0 for e in l_estimator}
 
     for machine_pair in machine_pairs:
         machine1 = machine_pair[0]
@@ -128,32 +193,25 @@ def print_ranking_mistakes():
                     for t in l_type:
                         print("        * TYPE: " + t)
                         try:
-                            [real_machine1, estimate1_machine1, estimate2_machine1, estimate3_machine1] = get_results(
+                            [real_machine1, *estimates_machine1] = get_results(
                                 {"app": app, "num_tasks": num_tasks, "data_size": data_size, "type": t, "machine": machine1})
-                            [real_machine2, estimate1_machine2, estimate2_machine2, estimate3_machine2] = get_results(
+                            [real_machine2, *estimates_machine2] = get_results(
                                 {"app": app, "num_tasks": num_tasks, "data_size": data_size, "type": t, "machine": machine2})
                         except:
                             print("           NO RESULTS")
                             continue
-                        if (estimate1_machine1 <= 0) or (estimate1_machine2 <= 0):
+                        if (estimates_machine1[0] <= 0) or (estimates_machine2[0] <= 0):
                             continue
                         real_faster = real_machine1 < real_machine2
-                        estimate1_faster = estimate1_machine1 < estimate1_machine2
-                        estimate2_faster = estimate2_machine1 < estimate2_machine2
-                        estimate3_faster = estimate3_machine1 < estimate3_machine2
-                        print("          * ESTIMATE1 CORRECT: " + str(estimate1_faster == real_faster))
-                        print("          * ESTIMATE2 CORRECT: " + str(estimate2_faster == real_faster))
-                        print("          * ESTIMATE3 CORRECT: " + str(estimate3_faster == real_faster))
-                        estimate1_wrong += estimate1_faster != real_faster
-                        estimate2_wrong += estimate2_faster != real_faster
-                        estimate3_wrong += estimate3_faster != real_faster
-                        estimate1_right += estimate1_faster == real_faster
-                        estimate2_right += estimate2_faster == real_faster
-                        estimate3_right += estimate3_faster == real_faster
-
-    print("ESTIMATE 1: WRONG " + str(estimate1_wrong) + "  RIGHT " + str(estimate1_right))
-    print("ESTIMATE 2: WRONG " + str(estimate2_wrong) + "  RIGHT " + str(estimate2_right))
-    print("ESTIMATE 3: WRONG " + str(estimate3_wrong) + "  RIGHT " + str(estimate3_right))
+                        for (i, e) in enumerate(l_estimator):
+                            estimate_faster = estimates_machine1[i] < estimates_machine2[i]
+                            print("          * " + e.upper() + " CORRECT: " + str(estimate_faster == real_faster))
+                            wrong[e] += estimate_faster != real_faster
+                            right[e] += estimate_faster == real_faster
+
+    for e in l_estimator:
+        label = e.upper().replace("ESTIMATE", "ESTIMATE ", 1)
+        print(label + ": WRONG " + str(wrong[e]) + "  RIGHT " + str(right[e]))
 
 
 def main():
@@ -0,0 +1,192 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <AccuracyEvaluator.h>
+
+/**
+ * @brief Get a table cell as a string (numbers are formatted as integers, as they are labels)
+ */
+static std::string cell_string(const struct result_table &table, long column, unsigned long row) {
+    if (table.schema[column].type == column_type::STRING) {
+        return table.strings[column][row];
+    }
+    return std::to_string((long)table.numbers[column][row]);
+}
+
+/**
+ * @brief Get the index of a required column
+ */
+static long required_column(const struct result_table &table, const std::string &name) {
+    long index = table.getColumnIndex(name);
+    if (index < 0) {
+        throw std::invalid_argument("AccuracyEvaluator::evaluate(): missing column " + name);
+    }
+    return index;
+}
+
+/**
+ * Documentation in .h file
+ */
+std::vector<struct estimator_accuracy> AccuracyEvaluator::evaluate(const struct result_table &real,
+                                                                   const struct result_table &model,
+                                                                   unsigned long num_threads) {
+
+    const std::vector<std::string> case_columns = {"app", "num_tasks", "data_size", "type"};
+
+    // Estimator columns
+    std::vector<long> estimator_columns;
+    for (unsigned long c = 0; c < model.schema.size(); c++) {
+        auto const &name = model.schema[c].name;
+        if ((name.rfind("estimate", 0) == 0) and (name.find('_') == std::string::npos) and
+            (model.schema[c].type != column_type::STRING)) {
+            estimator_columns.push_back((long)c);
+        }
+    }
+    if (estimator_columns.empty()) {
+        throw std::invalid_argument("AccuracyEvaluator::evaluate(): no estimate column in model results");
+    }
+    const unsigned long num_estimators = estimator_columns.size();
+
+    // Index measured makespans by (case, machine), keeping the first one of each
+    std::vector<long> real_case_columns;
+    std::vector<long> model_case_columns;
+    for (auto const &name : case_columns) {
+        real_case_columns.push_back(required_column(real, name));
+        model_case_columns.push_back(required_column(model, name));
+    }
+    long real_machine_column = required_column(real, "machine");
+    long model_machine_column = required_column(model, "machine");
+    long real_makespan_column = required_column(real, "makespan");
+    if (real.schema[real_makespan_column].type == column_type::STRING) {
+        throw std::invalid_argument("AccuracyEvaluator::evaluate(): non-numeric makespan column");
+    }
+
+    auto case_key = [](const struct result_table &table, const std::vector<long> &columns, unsigned long row) {
+        std::string key;
+        for (auto c : columns) {
+            key += cell_string(table, c, row);
+            key.push_back('\x1f');
+        }
+        return key;
+    };
+
+    std::vector<std::string> case_keys;
+    std::vector<std::string> machines;
+    std::vector<double> makespans;
+    std::unordered_map<std::string, unsigned long> index;
+    for (unsigned long r = 0; r < real.num_rows; r++) {
+        if (std::isnan(real.numbers[real_makespan_column][r])) {
+            continue;
+        }
+        std::string key = case_key(real, real_case_columns, r);
+        std::string machine = cell_string(real, real_machine_column, r);
+        if (index.emplace(key + machine, makespans.size()).second) {
+            case_keys.push_back(key);
+            machines.push_back(machine);
+            makespans.push_back(real.numbers[real_makespan_column][r]);
+        }
+    }
+
+    // Join estimates (entries without estimates have zero estimates)
+    std::vector<double> estimates(makespans.size() * num_estimators, 0.0);
+    for (unsigned long r = 0; r < model.num_rows; r++) {
+        auto it = index.find(case_key(model, model_case_columns, r) + cell_string(model, model_machine_column, r));
+        if (it == index.end()) {
+            continue;
+        }
+        for (unsigned long e = 0; e < num_estimators; e++) {
+            estimates[it->second * num_estimators + e] = model.numbers[estimator_columns[e]][r];
+        }
+    }
+
+    // Group entries by case, with machines in name order
+    std::unordered_map<std::string, unsigned long> case_index;
+    std::vector<std::vector<unsigned long>> cases;
+    for (unsigned long i = 0; i < makespans.size(); i++) {
+        auto it = case_index.emplace(case_keys[i], cases.size());
+        if (it.second) {
+            cases.emplace_back();
+        }
+        cases[it.first->second].push_back(i);
+    }
+    for (auto &c : cases) {
+        std::sort(c.begin(), c.end(), [&machines](unsigned long a, unsigned long b) {
+            return machines[a] < machines[b];
+        });
+    }
+
+    // Count ranking mistakes over all machine pairs of all cases, in parallel
+    num_threads = std::max<unsigned long>(1, std::min<unsigned long>(num_threads, cases.size()));
+    std::vector<std::vector<unsigned long>> wrong(num_threads, std::vector<unsigned long>(num_estimators, 0));
+    std::vector<std::vector<unsigned long>> right(num_threads, std::vector<unsigned long>(num_estimators, 0));
+    std::vector<std::thread> workers;
+    for (unsigned long t = 0; t < num_threads; t++) {
+        workers.emplace_back([&, t]() {
+            for (unsigned long c = t * cases.size() / num_threads; c < (t + 1) * cases.size() / num_threads; c++) {
+                auto const &entries = cases[c];
+                for (unsigned long i = 0; i < entries.size(); i++) {
+                    const double *estimates1 = estimates.data() + entries[i] * num_estimators;
+                    if (estimates1[0] <= 0) {
+                        continue;
+                    }
+                    for (unsigned long j = i + 1; j < entries.size(); j++) {
+                        const double *estimates2 = estimates.data() + entries[j] * num_estimators;
+                        if (estimates2[0] <= 0) {
+                            continue;
+                        }
+                        bool real_faster = makespans[entries[i]] < makespans[entries[j]];
+                        for (unsigned long e = 0; e < num_estimators; e++) {
+                            bool estimate_faster = estimates1[e] < estimates2[e];
+                            wrong[t][e] += (estimate_faster != real_faster);
+                            right[t][e] += (estimate_faster == real_faster);
+                        }
+                    }
+                }
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+
+    // Reduce, and compute relative errors
+    std::vector<struct estimator_accuracy> accuracies;
+    for (unsigned long e = 0; e < num_estimators; e++) {
+        struct estimator_accuracy accuracy{};
+        accuracy.name = model.schema[estimator_columns[e]].name;
+        for (unsigned long t = 0; t < num_threads; t++) {
+            accuracy.num_wrong += wrong[t][e];
+            accuracy.num_right += right[t][e];
+        }
+        std::vector<double> errors;
+        for (unsigned long i = 0; i < makespans.size(); i++) {
+            if (estimates[i * num_estimators] > 0) {
+                errors.push_back(std::fabs(estimates[i * num_estimators + e] - makespans[i]) / makespans[i]);
+            }
+        }
+        accuracy.num_estimates = errors.size();
+        if (not errors.empty()) {
+            double sum = 0.0;
+            for (auto err : errors) {
+                sum += err;
+                accuracy.max_relative_error = std::max<double>(accuracy.max_relative_error, err);
+            }
+            accuracy.mean_relative_error = sum / (double)errors.size();
+            std::nth_element(errors.begin(), errors.begin() + (long)(errors.size() / 2), errors.end());
+            accuracy.median_relative_error = errors[errors.size() / 2];
+        }
+        accuracies.push_back(accuracy);
+    }
+    return accuracies;
+}
@@ -0,0 +1,269 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#include <BatchEstimator.h>
+#include <MakespanEstimators.h>
+
+#if defined(__AVX512F__)
+#define BATCH_LANES 8
+#else
+#define BATCH_LANES 4
+#endif
+
+/**
+ * @brief Add the (contended) makespans of the tasks of a level to the per-lane accumulators of the full
+ *        batches and of the last batch, a task being in the last batch of a lane if its rank in the sort is
+ *        at least the lane's start of the last batch. The operations, and their order (tasks are summed in
+ *        task order), are those of estimate_makespan_level(), so that each lane computes exactly what the
+ *        scalar estimator computes.
+ *
+ * @param full_acc: the per-lane accumulators of the full batches
+ * @param last_acc: the per-lane accumulators of the last batch
+ * @param full_contention: the per-lane I/O contention of the full batches
+ * @param last_contention: the per-lane I/O contention of the last batch
+ * @param last_batch_starts: the per-lane rank of the first task of the last batch
+ * @param ranks: the per-task ranks in the sort
+ * @param io_times: the per-task I/O times (no contention)
+ * @param work_times: the per-task compute times
+ * @param width: the number of tasks
+ */
+static inline void accumulate_lanes(double *full_acc,
+                                    double *last_acc,
+                                    const double *full_contention,
+                                    const double *last_contention,
+                                    const double *last_batch_starts,
+                                    const double *ranks,
+                                    const double *io_times,
+                                    const double *work_times,
+                                    unsigned long width) {
+#if defined(__AVX512F__)
+    __m512d fa = _mm512_loadu_pd(full_acc);
+    __m512d la = _mm512_loadu_pd(last_acc);
+    __m512d fc = _mm512_loadu_pd(full_contention);
+    __m512d lc = _mm512_loadu_pd(last_contention);
+    __m512d ls = _mm512_loadu_pd(last_batch_starts);
+    for (unsigned long t = 0; t < width; t++) {
+        __mmask8 full = _mm512_cmp_pd_mask(_mm512_set1_pd(ranks[t]), ls, _CMP_LT_OQ);
+        __m512d io = _mm512_set1_pd(io_times[t]);
+        __m512d w = _mm512_set1_pd(work_times[t]);
+        fa = _mm512_mask_add_pd(fa, full, fa, _mm512_add_pd(_mm512_mul_pd(fc, io), w));
+        la = _mm512_mask_add_pd(la, (__mmask8)~full, la, _mm512_add_pd(_mm512_mul_pd(lc, io), w));
+    }
+    _mm512_storeu_pd(full_acc, fa);
+    _mm512_storeu_pd(last_acc, la);
+#elif defined(__AVX2__)
+    // Adding +0.0 to the accumulators of the other batch leaves them unchanged (they are not negative)
+    __m256d fa = _mm256_loadu_pd(full_acc);
+    __m256d la = _mm256_loadu_pd(last_acc);
+    __m256d fc = _mm256_loadu_pd(full_contention);
+    __m256d lc = _mm256_loadu_pd(last_contention);
+    __m256d ls = _mm256_loadu_pd(last_batch_starts);
+    for (unsigned long t = 0; t < width; t++) {
+        __m256d full = _mm256_cmp_pd(_mm256_set1_pd(ranks[t]), ls, _CMP_LT_OQ);
+        __m256d io = _mm256_set1_pd(io_times[t]);
+        __m256d w = _mm256_set1_pd(work_times[t]);
+        fa = _mm256_add_pd(fa, _mm256_and_pd(full, _mm256_add_pd(_mm256_mul_pd(fc, io), w)));
+        la = _mm256_add_pd(la, _mm256_andnot_pd(full, _mm256_add_pd(_mm256_mul_pd(lc, io), w)));
+    }
+    _mm256_storeu_pd(full_acc, fa);
+    _mm256_storeu_pd(last_acc, la);
+#else
+    for (unsigned long t = 0; t < width; t++) {
+        for (int k = 0; k < BATCH_LANES; k++) {
+            if (ranks[t] < last_batch_starts[k]) {
+                full_acc[k] = full_acc[k] + (full_contention[k] * io_times[t] + work_times[t]);
+            } else {
+                last_acc[k] = last_acc[k] + (last_contention[k] * io_times[t] + work_times[t]);
+            }
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Estimate a level's makespan for up to BATCH_LANES configurations that share the level's task order
+ *
+ * @param width: the number of tasks in the level
+ * @param ranks: the per-task ranks in the sort
+ * @param io_times: the per-task I/O times (no contention)
+ * @param work_times: the per-task compute times
+ * @param num_nodes: the per-lane number of nodes
+ * @param batch_sizes: the per-lane batch size (number of nodes * number of cores per node)
+ * @param io_contention_exponent: the I/O contention exponent (see compute_io_contention())
+ * @param makespans: the per-lane makespans, to which the level's makespans are added
+ */
+static void estimate_makespan_level_lanes(unsigned long width,
+                                          const double *ranks,
+                                          const double *io_times,
+                                          const double *work_times,
+                                          const double *num_nodes,
+                                          const unsigned long *batch_sizes,
+                                          double io_contention_exponent,
+                                          double *makespans) {
+    double full_acc[BATCH_LANES];
+    double last_acc[BATCH_LANES];
+    double full_contention[BATCH_LANES];
+    double last_contention[BATCH_LANES];
+    double last_batch_starts[BATCH_LANES];
+    auto lane_contention = [&](unsigned long num_tasks, int k) -> double {
+        double tasks_per_node = (double)num_tasks / num_nodes[k];
+        return io_contention_exponent == 1.0 ? tasks_per_node : std::pow(tasks_per_node, io_contention_exponent);
+    };
+
+    for (int k = 0; k < BATCH_LANES; k++) {
+        full_acc[k] = 0;
+        last_acc[k] = 0;
+        full_contention[k] = lane_contention(batch_sizes[k], k);
+        last_contention[k] = lane_contention(width % batch_sizes[k], k);
+        last_batch_starts[k] = (double)(width - width % batch_sizes[k]);
+    }
+
+    accumulate_lanes(full_acc, last_acc, full_contention, last_contention, last_batch_starts,
+                     ranks, io_times, work_times, width);
+
+    // Average task run times accounting for contention
+    for (int k = 0; k < BATCH_LANES; k++) {
+        unsigned long last_batch_size = width % batch_sizes[k];
+        double level_makespan = 0.0;
+        if (width - last_batch_size > 0) {
+            level_makespan += full_acc[k] / (double)batch_sizes[k];
+        }
+        if (last_batch_size > 0) {
+            level_makespan += last_acc[k] / (double)last_batch_size;
+        }
+        makespans[k] += level_makespan;
+    }
+}
+
+/**
+ * Documentation in .h file
+ */
+std::vector<double> estimate_makespan_critical_path_batch(const WorkflowSummary &summary,
+                                                          const std::vector<struct platform_config> &configs,
+                                                          unsigned long num_threads) {
+    for (auto const &config : configs) {
+        if (config.num_nodes * config.num_cores_per_node == 0) {
+            throw std::invalid_argument("estimate_makespan_critical_path_batch(): the numbers of nodes and of "
+                                        "cores per node should be > 0");
+        }
+    }
+
+    std::vector<double> estimates(configs.size(), 0.0);
+
+    // Grouped summaries are cheap to estimate one configuration at a time, multi-core tasks are packed
+    // differently for each configuration, and overlapped task makespans are not linear in the contention
+    if (summary.isGrouped() or summary.hasMultiCoreTasks() or summary.hasOverlap()) {
+        for (unsigned long i = 0; i < configs.size(); i++) {
+            estimates[i] = estimate_makespan_critical_path(summary, configs[i], num_threads);
+        }
+        return estimates;
+    }
+
+    // Group the configurations that order tasks identically (and have the same contention exponent)
+    std::map<std::tuple<double, double, double, double>, std::vector<unsigned long>> groups;
+    for (unsigned long i = 0; i < configs.size(); i++) {
+        groups[std::make_tuple(configs[i].task_execution_time,
+                               configs[i].io_read_speed_per_node,
+                               configs[i].io_write_speed_per_node,
+                               configs[i].io_contention_exponent)].push_back(i);
+    }
+
+    const unsigned long num_levels = summary.getNumLevels();
+    num_threads = std::max<unsigned long>(1, std::min<unsigned long>(num_threads, num_levels));
+    std::vector<EstimationWorkspace> workspaces(num_threads, EstimationWorkspace(summary));
+
+    for (auto const &group : groups) {
+        auto const &members = group.second;
+        const struct platform_config &config = configs[members.front()];
+
+        // Lay out the lanes (the last chunk is padded by repeating its last configuration)
+        unsigned long num_chunks = (members.size() + BATCH_LANES - 1) / BATCH_LANES;
+        unsigned long num_lanes = num_chunks * BATCH_LANES;
+        std::vector<double> num_nodes(num_lanes);
+        std::vector<unsigned long> batch_sizes(num_lanes);
+        std::vector<double> makespans(num_lanes, 0.0);
+        for (unsigned long k = 0; k < num_nodes.size(); k++) {
+            auto const &c = configs[members[std::min<unsigned long>(k, members.size() - 1)]];
+            num_nodes[k] = (double)c.num_nodes;
+            batch_sizes[k] = c.num_nodes * c.num_cores_per_node;
+        }
+
+        // Add the level's per-lane makespans to level_makespans
+        auto estimate_level = [&](unsigned long level, EstimationWorkspace &workspace, double *level_makespans) {
+            const unsigned long offset = summary.level_offsets[level];
+            const unsigned long width = summary.getLevelWidth(level);
+            double *ranks = workspace.keys.data();
+            double *io_times = workspace.io_times.data();
+            double *work_times = workspace.work_times.data();
+
+            // Once sorted, the keys are no longer needed, and hold the ranks of the tasks
+            sort_level_tasks(summary, level, config, workspace);
+            for (unsigned long i = 0; i < width; i++) {
+                ranks[workspace.order[i]] = (double)i;
+            }
+            for (unsigned long i = 0; i < width; i++) {
+                unsigned long t = offset + i;
+                io_times[i] = summary.bytes_read[t] / config.io_read_speed_per_node +
+                              summary.bytes_written[t] / config.io_write_speed_per_node;
+                work_times[i] = summary.work[t] * config.task_execution_time;
+            }
+
+            for (unsigned long chunk = 0; chunk < num_chunks; chunk++) {
+                estimate_makespan_level_lanes(width, ranks, io_times, work_times,
+                                              num_nodes.data() + chunk * BATCH_LANES,
+                                              batch_sizes.data() + chunk * BATCH_LANES,
+                                              config.io_contention_exponent,
+                                              level_makespans + chunk * BATCH_LANES);
+            }
+        };
+
+        if (num_threads == 1) {
+            for (unsigned long level = 0; level < num_levels; level++) {
+                estimate_level(level, workspaces[0], makespans.data());
+            }
+        } else {
+            // Levels are estimated concurrently, each thread taking the next level to estimate, and their
+            // makespans are then summed in level order, as in the serial case
+            std::vector<double> level_makespans(num_levels * num_lanes, 0.0);
+            std::atomic<unsigned long> next(0);
+            std::vector<std::thread> workers;
+            for (unsigned long t = 0; t < num_threads; t++) {
+                workers.emplace_back([&, t]() {
+                    for (unsigned long level = next++; level < num_levels; level = next++) {
+                        estimate_level(level, workspaces[t], level_makespans.data() + level * num_lanes);
+                    }
+                });
+            }
+            for (auto &w : workers) {
+                w.join();
+            }
+            for (unsigned long level = 0; level < num_levels; level++) {
+                for (unsigned long k = 0; k < num_lanes; k++) {
+                    makespans[k] += level_makespans[level * num_lanes + k];
+                }
+            }
+        }
+
+        for (unsigned long k = 0; k < members.size(); k++) {
+            estimates[members[k]] = makespans[k];
+        }
+    }
+
+    return estimates;
+}
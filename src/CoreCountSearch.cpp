@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <CoreCountSearch.h>
+
+/**
+ * Documentation in .h file
+ */
+std::vector<unsigned long> CoreCountSearch::getCandidateNumNodes(const WorkflowSummary &summary,
+                                                                 unsigned long num_cores_per_node,
+                                                                 unsigned long max_num_nodes) {
+    std::vector<unsigned long> candidates = {1, max_num_nodes};
+
+    for (unsigned long l = 0; l < summary.getNumLevels(); l++) {
+        unsigned long width = summary.getLevelWidth(l);
+        if (summary.isGrouped()) {
+            width = 0;
+            for (unsigned long i = summary.level_offsets[l]; i < summary.level_offsets[l + 1]; i++) {
+                width += summary.multiplicity[i];
+            }
+        }
+
+        if (width == 0) {
+            continue;
+        }
+
+        // n(k) = ceil(width / (k * p)) for k batches, jumping from one distinct value to the next
+        unsigned long k = 1;
+        while (true) {
+            unsigned long n = (width + k * num_cores_per_node - 1) / (k * num_cores_per_node);
+            if (n <= max_num_nodes) {
+                candidates.push_back(n);
+            }
+            if (n <= 1) {
+                break;
+            }
+            // Smallest k for which width / (k * p) <= n - 1
+            k = std::max<unsigned long>(k + 1, (width + (n - 1) * num_cores_per_node - 1) / ((n - 1) * num_cores_per_node));
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    return candidates;
+}
+
+/**
+ * Documentation in .h file
+ */
+unsigned long CoreCountSearch::findMinimalNumNodes(const std::vector<unsigned long> &candidates,
+                                                   const std::function<double(unsigned long)> &estimate,
+                                                   double deadline) {
+    if (candidates.empty() or (estimate(candidates.back()) > deadline)) {
+        return 0;
+    }
+
+    // Smallest candidate that meets the deadline
+    unsigned long low = 0;
+    unsigned long high = candidates.size() - 1;
+    while (low < high) {
+        unsigned long mid = (low + high) / 2;
+        if (estimate(candidates[mid]) <= deadline) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    if (high == 0) {
+        return candidates[0];
+    }
+
+    // Smallest number of nodes, between the previous candidate (excluded) and that candidate
+    unsigned long low_nodes = candidates[high - 1] + 1;
+    unsigned long high_nodes = candidates[high];
+    while (low_nodes < high_nodes) {
+        unsigned long mid = (low_nodes + high_nodes) / 2;
+        if (estimate(mid) <= deadline) {
+            high_nodes = mid;
+        } else {
+            low_nodes = mid + 1;
+        }
+    }
+    return high_nodes;
+}
+
+/**
+ * Documentation in .h file
+ */
+std::vector<unsigned long> CoreCountSearch::getParetoFront(const std::vector<unsigned long> &num_nodes,
+                                                           const std::vector<double> &makespans) {
+    std::vector<unsigned long> front;
+    for (unsigned long i = 0; i < num_nodes.size(); i++) {
+        if (front.empty() or (makespans[i] < makespans[front.back()])) {
+            front.push_back(i);
+        }
+    }
+    return front;
+}
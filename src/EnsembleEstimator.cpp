@@ -0,0 +1,170 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <EnsembleEstimator.h>
+
+/**
+ * Documentation in .h file
+ */
+struct ensemble_estimate EnsembleEstimator::estimate(const WorkflowSummary &ensemble,
+                                                     const struct platform_config &config,
+                                                     enum ensemble_policy policy,
+                                                     const std::vector<double> &priorities,
+                                                     EstimationWorkspace &workspace) {
+    if (ensemble.isGrouped()) {
+        throw std::invalid_argument("EnsembleEstimator::estimate(): the ensemble summary cannot be grouped");
+    }
+    const unsigned long num_members = ensemble.isEnsemble() ? ensemble.num_members : 1;
+    if ((policy == PRIORITY) and (priorities.size() != num_members)) {
+        throw std::invalid_argument("EnsembleEstimator::estimate(): there must be one priority per workflow");
+    }
+
+    struct ensemble_estimate estimate{0.0, std::vector<double>(num_members, 0.0)};
+    if (policy == FAIR_SHARE) {
+        // All workflows complete their level at the end of the level
+        for (unsigned long l = 0; l < ensemble.getNumLevels(); l++) {
+            estimate.makespan += estimate_makespan_level(ensemble, l, config, workspace);
+            for (unsigned long t = ensemble.level_offsets[l]; t < ensemble.level_offsets[l + 1]; t++) {
+                estimate.completion_times[ensemble.isEnsemble() ? ensemble.member[t] : 0] = estimate.makespan;
+            }
+        }
+        return estimate;
+    }
+
+    // Ranks of the workflows, by decreasing priority (ties broken by workflow order)
+    std::vector<unsigned long> members(num_members);
+    std::iota(members.begin(), members.end(), 0);
+    std::stable_sort(members.begin(), members.end(), [&priorities](unsigned long a, unsigned long b) {
+        return priorities[a] > priorities[b];
+    });
+    std::vector<unsigned long> ranks(num_members);
+    for (unsigned long r = 0; r < num_members; r++) {
+        ranks[members[r]] = r;
+    }
+    for (unsigned long l = 0; l < ensemble.getNumLevels(); l++) {
+        estimate.makespan += estimateLevelByPriority(ensemble, l, config, ranks, estimate.makespan, workspace,
+                                                     estimate.completion_times);
+    }
+    return estimate;
+}
+
+/**
+ * @brief Estimate the makespan of a level of an ensemble with the priority policy. Tasks are sorted by
+ *        workflow rank, and then by decreasing makespan (without contention), and packed into phases with the
+ *        next-fit heuristic of the critical path estimate (see estimate_makespan_level()), so that the tasks
+ *        of the workflows with the highest priorities run in the first phases.
+ *
+ * @param ensemble: the ensemble summary
+ * @param level: the level
+ * @param config: the platform configuration
+ * @param ranks: the rank of each workflow
+ * @param start: the start time of the level
+ * @param workspace: the workspace
+ * @param completion_times: the completion time of each workflow, which is updated for those that have tasks in
+ *                          the level (to the end of the phase of their last task)
+ * @return a makespan in seconds
+ */
+double EnsembleEstimator::estimateLevelByPriority(const WorkflowSummary &ensemble,
+                                                  unsigned long level,
+                                                  const struct platform_config &config,
+                                                  const std::vector<unsigned long> &ranks,
+                                                  double start,
+                                                  EstimationWorkspace &workspace,
+                                                  std::vector<double> &completion_times) {
+
+    const unsigned long offset = ensemble.level_offsets[level];
+    const unsigned long width = ensemble.getLevelWidth(level);
+    const double *bytes_read = ensemble.bytes_read.data() + offset;
+    const double *bytes_written = ensemble.bytes_written.data() + offset;
+    const double *work = ensemble.work.data() + offset;
+    const unsigned long *num_cores = ensemble.num_cores.data() + offset;
+    const unsigned long *member = ensemble.isEnsemble() ? ensemble.member.data() + offset : nullptr;
+    const double *overlap = ensemble.hasOverlap() ? ensemble.overlap.data() + offset : nullptr;
+    double *keys = workspace.keys.data();
+    unsigned long *order = workspace.order.data();
+    double *io_times = workspace.io_times.data();
+    double *work_times = workspace.work_times.data();
+
+    for (unsigned long t = 0; t < width; t++) {
+        unsigned long cores = std::min<unsigned long>(num_cores[t], config.num_cores_per_node);
+        io_times[t] = bytes_read[t] / config.io_read_speed_per_node + bytes_written[t] / config.io_write_speed_per_node;
+        work_times[t] = work[t] * config.task_execution_time;
+        if (cores > 1) {
+            work_times[t] *= (1.0 - config.parallel_fraction) + config.parallel_fraction / (double)cores;
+        }
+        keys[t] = io_times[t] + work_times[t];
+        if (overlap) {
+            keys[t] -= overlap[t] * std::min<double>(io_times[t], work_times[t]);
+        }
+        order[t] = t;
+    }
+    auto rank = [member, &ranks](unsigned long t) -> unsigned long {
+        return member ? ranks[member[t]] : 0;
+    };
+    std::sort(order, order + width, [keys, &rank](unsigned long a, unsigned long b) -> bool {
+        return (rank(a) < rank(b)) or
+               ((rank(a) == rank(b)) and ((keys[a] > keys[b]) or ((keys[a] == keys[b]) and (a < b))));
+    });
+
+    // Pack tasks into phases (the tasks of a phase being order[first] to order[last - 1])
+    double level_makespan = 0.0;
+    auto end_phase = [&](unsigned long first, unsigned long last) {
+        double io_contention = compute_io_contention(last - first, config);
+        double sum_task_makespans = 0.0;
+        for (unsigned long i = first; i < last; i++) {
+            unsigned long t = order[i];
+            double io_time = io_contention * io_times[t];
+            sum_task_makespans += io_time + work_times[t];
+            if (overlap) {
+                sum_task_makespans -= overlap[t] * std::min<double>(io_time, work_times[t]);
+            }
+        }
+        level_makespan += sum_task_makespans / (double)(last - first);
+        for (unsigned long i = first; i < last; i++) {
+            completion_times[member ? member[order[i]] : 0] = start + level_makespan;
+        }
+    };
+    unsigned long node = 0;
+    unsigned long idle_cores = config.num_cores_per_node;
+    unsigned long first = 0;
+    for (unsigned long i = 0; i < width; i++) {
+        unsigned long cores = std::min<unsigned long>(num_cores[order[i]], config.num_cores_per_node);
+        if (cores > idle_cores) {
+            idle_cores = config.num_cores_per_node;
+            if (++node == config.num_nodes) {
+                end_phase(first, i);
+                node = 0;
+                first = i;
+            }
+        }
+        idle_cores -= cores;
+    }
+    if (width > first) {
+        end_phase(first, width);
+    }
+
+    return level_makespan;
+}
+
+/**
+ * Documentation in .h file
+ */
+enum ensemble_policy EnsembleEstimator::parsePolicy(const std::string &name) {
+    if (name == "fair_share") {
+        return FAIR_SHARE;
+    }
+    if (name == "priority") {
+        return PRIORITY;
+    }
+    throw std::invalid_argument("EnsembleEstimator::parsePolicy(): unknown policy " + name +
+                                " (expected fair_share or priority)");
+}
@@ -11,171 +11,895 @@
 #include <iostream>
 #include <wrench-dev.h>
 #include <boost/program_options.hpp>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <random>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
 #include <UnitParser.h>
 #include <wrench/tools/wfcommons/WfCommonsWorkflowParser.h>
 #include <WfCommonsWorkflowParser.h>
+#include <PlatformSpec.h>
+#include <WorkflowSummary.h>
+#include <MakespanEstimators.h>
+#include <MakespanBounds.h>
+#include <CoreCountSearch.h>
+#include <MonteCarloEstimator.h>
+#include <BatchEstimator.h>
+#include <EstimatorRegistry.h>
+#include <StreamingWorkflowReader.h>
+#include <WorkflowFingerprint.h>
+#include <ResultCache.h>
+#include <SimulationFarm.h>
+#include <SensitivityAnalysis.h>
+#include <EnsembleEstimator.h>
+#include <ResultWriter.h>
+#include <ResultReader.h>
+#include <AccuracyEvaluator.h>
+#include <PlatformCalibration.h>
 #include <boost/algorithm/string.hpp>
 
-#define GFLOP (1000.0 * 1000.0 * 1000.0)
-#define TFLOP (1000.0 * 1000.0 * 1000.0 * 1000.0)
-#define MBYTE (1000.0 * 1000.0)
-#define GBYTE (1000.0 * 1000.0 * 1000.0)
-
 namespace po = boost::program_options;
 
-struct platform_spec {
-    unsigned num_cores_per_node;
-    double cpu_task_execution_time;
-    double mem_task_execution_time;
-    double io_read_speed_per_node;
-    double io_write_speed_per_node;
-};
-
-std::map<std::string, struct platform_spec> platform_specs = {
-    { "Summit",
-        {
-                40,
-                20.624, // time python3 wfbench.py --percent-cpu 0.9 --cpu-work 500 abc
-                2 * 60.0 + 47.927, // time python3 wfbench.py --percent-cpu 0.1 --cpu-work 500 abc
-                466 * MBYTE, // time dd of=/dev/zero if=test-file iflag=direct bs=128k count=4k
-                59.9 * MBYTE // time dd if=/dev/zero of=test-file oflag=direct bs=128k count=4k
-        }
-    },
-    { "Piz Daint",
-        {
-                36,
-                7.132, // time python3 wfbench.py --percent-cpu 0.9 --cpu-work 500 abc
-                53.690, // time python3 wfbench.py --percent-cpu 0.1 --cpu-work 500 abc
-                45.3 * MBYTE, // time dd of=/dev/zero if=test-file iflag=direct bs=128k count=4k
-                13.3 * MBYTE // time dd if=/dev/zero of=test-file oflag=direct bs=128k count=4k
-        }
-    }
-};
-
-double compute_total_work(std::shared_ptr<wrench::Workflow> workflow) {
-    double total_flops = 0.0;
-    for (auto const &t : workflow->getTasks()) {
-        total_flops += t->getFlops();
-    }
-    return total_flops;
+/**
+ * @brief Derive the labels of a workflow from its file name, which is expected to be of the form
+ *        <app>-...-<num tasks>-...-<data size>.json (e.g., "blast-200-1000.json"). The app is the first
+ *        token, and the number of tasks and data size are the first and second numeric tokens. When
+ *        the file name does not include them, the number of tasks is that of the workflow, and the
+ *        data size is 0. Numeric tokens too large for a long are ignored.
+ *
+ * @param workflow_file: the workflow file path
+ * @param num_workflow_tasks: the number of tasks in the workflow
+ * @param app: the app label (output)
+ * @param num_tasks: the number of tasks label (output)
+ * @param data_size: the data size label (output)
+ */
+void get_workflow_labels(const std::string &workflow_file, unsigned long num_workflow_tasks,
+                         std::string &app, long &num_tasks, long &data_size) {
+    std::string stem = workflow_file.substr(workflow_file.find_last_of('/') == std::string::npos ? 0 : workflow_file.find_last_of('/') + 1);
+    if (boost::algorithm::ends_with(stem, ".json")) {
+        stem = stem.substr(0, stem.size() - 5);
+    }
+    std::vector<std::string> tokens;
+    boost::split(tokens, stem, boost::is_any_of("-"));
+    app = tokens.at(0);
+    std::vector<long> numbers;
+    for (unsigned long i = 1; i < tokens.size(); i++) {
+        // Tokens that do not fit in a long are not numeric
+        const std::string &token = tokens.at(i);
+        long number;
+        auto result = std::from_chars(token.data(), token.data() + token.size(), number);
+        if ((not token.empty()) and (result.ec == std::errc()) and (result.ptr == token.data() + token.size())) {
+            numbers.push_back(number);
+        }
+    }
+    num_tasks = numbers.size() > 0 ? numbers.at(0) : (long)num_workflow_tasks;
+    data_size = numbers.size() > 1 ? numbers.at(1) : 0;
 }
 
-std::pair<double, double> compute_total_data(const std::shared_ptr<wrench::Workflow>& workflow) {
-    double total_read_data = 0.0;
-    double total_written_data = 0.0;
-    for (auto const &t : workflow->getTasks()) {
-        for (auto const &f: t->getInputFiles()) {
-            total_read_data += f->getSize();
+/**
+ * @brief The main function of the "evaluate" subcommand, which evaluates the accuracy of
+ *        estimates against measured makespans
+ *
+ * @param argc: argument count
+ * @param argv: argument array (argv[0] being the subcommand)
+ * @return 0 on success, non-zero otherwise
+ */
+int main_evaluate(int argc, char **argv) {
+
+    std::string real_file;
+    std::string model_file;
+    unsigned long num_threads;
+
+    po::options_description desc("Allowed options (evaluate)", 100);
+    desc.add_options()
+            ("help",
+             "Show this help message\n")
+            ("real", po::value<std::string>(&real_file)->required()->value_name("<path>"),
+             "Path to the measured makespans (CSV with columns app,num_tasks,data_size,type,makespan,machine)\n")
+            ("model", po::value<std::string>(&model_file)->required()->value_name("<path>"),
+             "Path to the estimates (as written by the estimator, in any output format)\n")
+            ("num_threads", po::value<unsigned long>(&num_threads)->default_value(std::max<unsigned long>(1, std::thread::hardware_concurrency()))->value_name("<num threads>"),
+             "Number of threads")
+            ;
+
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        if (vm.count("help")) {
+            std::cerr << desc << "\n";
+            exit(0);
         }
-        for (auto const &f: t->getOutputFiles()) {
-            total_written_data += f->getSize();
+        po::notify(vm);
+    } catch (std::exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        exit(1);
+    }
+
+    std::vector<struct estimator_accuracy> accuracies;
+    try {
+        auto real = ResultReader::readResults(real_file);
+        auto model = ResultReader::readResults(model_file);
+        accuracies = AccuracyEvaluator::evaluate(real, model, num_threads);
+    } catch (std::exception &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        exit(1);
+    }
+
+    for (auto const &a : accuracies) {
+        std::string label = boost::to_upper_copy(a.name);
+        if (boost::algorithm::starts_with(label, "ESTIMATE")) {
+            label.insert(8, " ");
         }
+        fprintf(stdout, "%s: WRONG %lu  RIGHT %lu\n", label.c_str(), a.num_wrong, a.num_right);
     }
-    return std::make_pair(total_read_data, total_written_data);
+    for (auto const &a : accuracies) {
+        std::string label = boost::to_upper_copy(a.name);
+        if (boost::algorithm::starts_with(label, "ESTIMATE")) {
+            label.insert(8, " ");
+        }
+        fprintf(stdout, "%s: RELATIVE ERROR MEAN %.2lf%%  MEDIAN %.2lf%%  MAX %.2lf%%  (%lu estimates)\n",
+                label.c_str(), 100.0 * a.mean_relative_error, 100.0 * a.median_relative_error,
+                100.0 * a.max_relative_error, a.num_estimates);
+    }
+    return 0;
 }
 
-double estimate_makespan_naive_no_overlap(const std::shared_ptr<wrench::Workflow>& workflow,
-                                          unsigned long num_nodes,
-                                          unsigned long num_cores_per_node,
-                                          double io_read_speed_per_node,
-                                          double io_write_speed_per_node) {
+/**
+ * @brief The main function of the "benchmark" subcommand, which times the critical path estimate of a
+ *        single (synthetic) level when selecting the tasks of its last batch (std::nth_element), and when
+ *        sorting all its tasks (std::sort), and checks that both estimates are identical
+ *
+ * @param argc: argument count
+ * @param argv: argument array (argv[0] being the subcommand)
+ * @return 0 on success, non-zero otherwise
+ */
+int main_benchmark(int argc, char **argv) {
 
-    auto total_data = compute_total_data(workflow);
-    double total_read_data = std::get<0>(total_data);
-    double total_written_data = std::get<1>(total_data);
+    unsigned long min_width;
+    unsigned long max_width;
+    unsigned long num_nodes;
+    unsigned long num_cores_per_node;
+    unsigned long seed;
 
-    double io_read_time = total_read_data / (io_read_speed_per_node * (double)num_nodes);
-    std::cerr << "\nIO READ TIME = " << io_read_time << "\n";
-    double compute_time = compute_total_work(workflow) / ((double)num_nodes * (double)num_cores_per_node);
-    std::cerr << "COMPUTE TIME = " << compute_time << "\n";
-    double io_write_time = total_written_data / (io_write_speed_per_node * (double)num_nodes);
-    std::cerr << "IO WRITE TIME = " << io_write_time << "\n";
+    po::options_description desc("Allowed options (benchmark)", 100);
+    desc.add_options()
+            ("help",
+             "Show this help message\n")
+            ("min_width", po::value<unsigned long>(&min_width)->default_value(10000)->value_name("<num tasks>"),
+             "Number of tasks of the narrowest level\n")
+            ("max_width", po::value<unsigned long>(&max_width)->default_value(10000000)->value_name("<num tasks>"),
+             "Number of tasks of the widest level (levels are 10 times wider than the previous one)\n")
+            ("num_nodes", po::value<unsigned long>(&num_nodes)->default_value(4)->value_name("<num nodes>"),
+             "Number of nodes\n")
+            ("num_cores_per_node", po::value<unsigned long>(&num_cores_per_node)->default_value(48)->value_name("<num cores>"),
+             "Number of cores per node\n")
+            ("seed", po::value<unsigned long>(&seed)->default_value(42)->value_name("<seed>"),
+             "Seed of the random task sizes")
+            ;
 
-    return io_read_time + compute_time + io_write_time;
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        if (vm.count("help")) {
+            std::cerr << desc << "\n";
+            exit(0);
+        }
+        po::notify(vm);
+        if ((min_width == 0) or (min_width > max_width) or (num_nodes == 0) or (num_cores_per_node == 0)) {
+            throw std::invalid_argument("invalid level widths or platform size");
+        }
+    } catch (std::exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        exit(1);
+    }
+
+    struct platform_config config = {};
+    config.num_nodes = num_nodes;
+    config.num_cores_per_node = num_cores_per_node;
+    config.task_execution_time = 10.0;
+    config.io_read_speed_per_node = 1000.0 * 1000 * 1000;
+    config.io_write_speed_per_node = 500.0 * 1000 * 1000;
+    config.parallel_fraction = 1.0;
+
+    std::mt19937_64 rng(seed);
+    std::lognormal_distribution<double> work(0.0, 0.5);
+    std::lognormal_distribution<double> bytes(std::log(100.0 * 1000 * 1000), 1.0);
+
+    fprintf(stdout, "%12s %15s %20s %8s %10s\n", "num_tasks", "std::sort (ms)", "std::nth_element (ms)", "speedup", "identical");
+    for (unsigned long width = min_width; width <= max_width; width *= 10) {
+        WorkflowSummary summary;
+        for (unsigned long t = 0; t < width; t++) {
+            summary.work.push_back(work(rng));
+            summary.bytes_read.push_back(bytes(rng));
+            summary.bytes_written.push_back(bytes(rng) / 10.0);
+            summary.num_cores.push_back(1);
+        }
+        summary.level_offsets = {0, width};
+        summary.num_tasks = width;
+        summary.max_level_width = width;
+        EstimationWorkspace workspace(summary);
+
+        auto start = std::chrono::steady_clock::now();
+        double sorted_makespan = estimate_makespan_level_sorted(summary, 0, config, workspace);
+        auto middle = std::chrono::steady_clock::now();
+        double selected_makespan = estimate_makespan_level(summary, 0, config, workspace);
+        auto end = std::chrono::steady_clock::now();
+
+        double sort_time = std::chrono::duration<double, std::milli>(middle - start).count();
+        double select_time = std::chrono::duration<double, std::milli>(end - middle).count();
+        fprintf(stdout, "%12lu %15.3lf %20.3lf %8.2lf %10s\n", width, sort_time, select_time,
+                sort_time / select_time, selected_makespan == sorted_makespan ? "yes" : "no");
+        if (width > max_width / 10) {
+            break;
+        }
+    }
+    return 0;
 }
 
-double estimate_makespan_naive_overlap(const std::shared_ptr<wrench::Workflow>& workflow,
-                                       unsigned long num_nodes,
-                                       unsigned long num_cores_per_node,
-                                       double io_read_speed_per_node,
-                                       double io_write_speed_per_node) {
+/**
+ * @brief The main function of the "simulate" subcommand, which runs full WRENCH simulations of a workflow
+ *        for all platform/core count configurations in a pool of worker processes, and writes the simulated
+ *        makespans (which can be used as the measured makespans of the "evaluate" subcommand)
+ *
+ * @param argc: argument count
+ * @param argv: argument array (argv[0] being the subcommand)
+ * @return 0 on success, non-zero otherwise
+ */
+int main_simulate(int argc, char **argv) {
+
+    /* Create a WRENCH simulation object, which worker processes inherit */
+    auto simulation = wrench::Simulation::createSimulation();
+    simulation->init(&argc, argv);
+
+    std::string workflow_file;
+    std::vector<std::string> s_platform_specs;
+    std::vector<unsigned long> num_cores;
+    double parallel_fraction;
+    unsigned long num_workers;
+    std::string output_file;
+    std::string output_format;
+
+    po::options_description desc("Allowed options (simulate)", 100);
+    desc.add_options()
+            ("help",
+             "Show this help message\n")
+            ("workflow", po::value<std::string>(&workflow_file)->required()->value_name("<path>"),
+             "Path to JSON workflow description file\n")
+            ("platform_spec", po::value<std::vector<std::string>>(&s_platform_specs)->required()->value_name("<cpu_task_exec_time:mem_task_exec_time:per_node_io_read_bw:per_node_io_write_bw:num_cores_per_nodes | name>"),
+             "Possible values:\n\t- specific values, e.g., 200:300:100MBps:80kbps:16\n\t- Summit\n\t- Piz Daint\n")
+            ("num_cores", po::value<std::vector<unsigned long>>(&num_cores)->required()->multitoken()->value_name("<num cores> [<num cores> ...]"),
+             "The total numbers of cores (one simulation per platform and number of cores)\n")
+            ("parallel_fraction", po::value<double>(&parallel_fraction)->default_value(1.0)->value_name("<fraction>"),
+             "Parallel fraction of the work of multi-core tasks, whose speedup follows Amdahl's law\n")
+            ("num_workers", po::value<unsigned long>(&num_workers)->default_value(std::max<unsigned long>(1, std::thread::hardware_concurrency()))->value_name("<num workers>"),
+             "Maximum number of simulations (worker processes) running at once\n")
+            ("output", po::value<std::string>(&output_file)->default_value("-")->value_name("<path>"),
+             "Path to the output file (\"-\" for stdout)\n")
+            ("output_format", po::value<std::string>(&output_format)->default_value("csv")->value_name("<csv | jsonl | binary>"),
+             "Format of the output file")
+            ;
+
+    po::variables_map vm;
+    std::vector<struct platform_spec> specs;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        if (vm.count("help")) {
+            std::cerr << desc << "\n";
+            exit(0);
+        }
+        po::notify(vm);
+        for (auto const &platform_spec : s_platform_specs) {
+            specs.push_back(parse_platform_spec(platform_spec));
+        }
+        if ((parallel_fraction < 0.0) or (parallel_fraction > 1.0)) {
+            throw std::invalid_argument("the parallel fraction must be between 0 and 1");
+        }
+        if (std::find(num_cores.begin(), num_cores.end(), 0) != num_cores.end()) {
+            throw std::invalid_argument("the number of cores must be > 0");
+        }
+    } catch (std::exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        exit(1);
+    }
+
+    /* Create the workflow once (tasks have one flop per unit of work) */
+    std::shared_ptr<wrench::Workflow> workflow;
+    try {
+        workflow = WfCommonsWorkflowParser::createWorkflowFromJSON(workflow_file, 1.0, false);
+        for (auto const &task : workflow->getTasks()) {
+            task->setParallelModel(wrench::ParallelModel::AMDAHL(parallel_fraction));
+        }
+    } catch (std::invalid_argument &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        exit(1);
+    }
 
-    auto total_data = compute_total_data(workflow);
-    double total_read_data = std::get<0>(total_data);
-    double total_written_data = std::get<1>(total_data);
+    std::vector<struct platform_config> configs;
+    std::vector<std::pair<unsigned long, unsigned long>> config_labels;
+    for (unsigned long s = 0; s < specs.size(); s++) {
+        for (auto const &n : num_cores) {
+            configs.push_back(make_platform_config(specs[s], specs[s].cpu_task_execution_time, n));
+            config_labels.emplace_back(s, n);
+        }
+    }
 
-    double io_read_time = total_read_data / (io_read_speed_per_node * (double)num_nodes);
-    double compute_time = compute_total_work(workflow) / ((double)num_nodes * (double)num_cores_per_node);
-    double io_write_time = total_written_data / (io_write_speed_per_node * (double)num_nodes);
+    std::vector<struct result_column> schema = {
+            {"app", column_type::STRING},
+            {"num_tasks", column_type::INTEGER},
+            {"data_size", column_type::INTEGER},
+            {"type", column_type::STRING},
+            {"makespan", column_type::REAL},
+            {"machine", column_type::STRING},
+            {"num_cores", column_type::INTEGER},
+            {"wall_time", column_type::REAL}};
+    std::unique_ptr<ResultWriter> writer;
+    try {
+        writer = ResultWriter::createResultWriter(output_format, output_file, schema);
+    } catch (std::invalid_argument &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        exit(1);
+    }
 
-    return std::max<double>(compute_time, io_read_time + io_write_time);
+    /* Run the simulations, reporting them as they complete */
+    unsigned long num_done = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<struct simulation_result> results;
+    try {
+        results = SimulationFarm::simulate(simulation, workflow, configs, num_workers,
+                                           [&](unsigned long c, const struct simulation_result &result) {
+            num_done++;
+            if (result.makespan < 0) {
+                fprintf(stderr, "SIMULATION %lu/%lu: PLATFORM %s, %lu CORES: FAILED (%.2lf seconds)\n",
+                        num_done, configs.size(), s_platform_specs[config_labels[c].first].c_str(),
+                        config_labels[c].second, result.wall_time);
+            } else {
+                fprintf(stderr, "SIMULATION %lu/%lu: PLATFORM %s, %lu CORES: %.1lf seconds (%.2lf seconds)\n",
+                        num_done, configs.size(), s_platform_specs[config_labels[c].first].c_str(),
+                        config_labels[c].second, result.makespan, result.wall_time);
+            }
+        });
+    } catch (std::invalid_argument &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        exit(1);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double total_wall_time = 0.0;
+    for (auto const &result : results) {
+        total_wall_time += result.wall_time;
+    }
+    fprintf(stderr, "%lu SIMULATIONS IN %.1lf SECONDS WITH %lu WORKERS (%.1lf SECONDS OF SIMULATION)\n",
+            configs.size(), elapsed, num_workers, total_wall_time);
+
+    /* Failed simulations have no row */
+    std::string app;
+    long num_tasks_label, data_size_label;
+    get_workflow_labels(workflow_file, workflow->getNumberOfTasks(), app, num_tasks_label, data_size_label);
+    int status = 0;
+    for (unsigned long c = 0; c < configs.size(); c++) {
+        if (results[c].makespan < 0) {
+            status = 1;
+            continue;
+        }
+        writer->addString(app);
+        writer->addInteger(num_tasks_label);
+        writer->addInteger(data_size_label);
+        writer->addString("cpu");
+        writer->addReal(results[c].makespan);
+        writer->addString(s_platform_specs[config_labels[c].first]);
+        writer->addInteger((long)config_labels[c].second);
+        writer->addReal(results[c].wall_time);
+        writer->endRow();
+    }
+    writer->close();
+    return status;
 }
 
-double compute_task_makespan(const std::shared_ptr<wrench::WorkflowTask>& task,
-                             double io_read_speed_per_node,
-                             double io_write_speed_per_node) {
-    double makespan = 0;
-    for (const auto &f : task->getInputFiles()) {
-        makespan += f->getSize() / io_read_speed_per_node;
+/**
+ * @brief Format the parameters of a sensitivity, most limiting first (e.g., "cpu > read > cores > write")
+ *
+ * @param sensitivity: the makespan sensitivity
+ * @return a string
+ */
+std::string format_bottlenecks(const struct makespan_sensitivity &sensitivity) {
+    std::string ranking;
+    for (auto const &parameter : SensitivityAnalysis::rankParameters(sensitivity)) {
+        ranking += (ranking.empty() ? "" : " > ") + SensitivityAnalysis::getParameterName(parameter);
     }
+    return ranking;
+}
 
-    makespan += task->getFlops();
+/**
+ * @brief The main function of the "sensitivity" subcommand, which computes the elasticities of the estimates
+ *        of a workflow with respect to the platform parameters, and reports the bottlenecks of each level
+ *
+ * @param argc: argument count
+ * @param argv: argument array (argv[0] being the subcommand)
+ * @return 0 on success, non-zero otherwise
+ */
+int main_sensitivity(int argc, char **argv) {
 
-    for (const auto &f : task->getOutputFiles()) {
-        makespan += f->getSize() / io_write_speed_per_node;
+    /* Create a WRENCH simulation object (to create the workflow) */
+    auto simulation = wrench::Simulation::createSimulation();
+    simulation->init(&argc, argv);
+
+    std::string workflow_file;
+    std::vector<std::string> s_platform_specs;
+    std::vector<unsigned long> num_cores;
+    double parallel_fraction;
+    double relative_step;
+    unsigned long num_threads;
+
+    po::options_description desc("Allowed options (sensitivity)", 100);
+    desc.add_options()
+            ("help",
+             "Show this help message\n")
+            ("workflow", po::value<std::string>(&workflow_file)->required()->value_name("<path>"),
+             "Path to JSON workflow description file\n")
+            ("platform_spec", po::value<std::vector<std::string>>(&s_platform_specs)->required()->value_name("<cpu_task_exec_time:mem_task_exec_time:per_node_io_read_bw:per_node_io_write_bw:num_cores_per_nodes | name>"),
+             "Possible values:\n\t- specific values, e.g., 200:300:100MBps:80kbps:16\n\t- Summit\n\t- Piz Daint\n")
+            ("num_cores", po::value<std::vector<unsigned long>>(&num_cores)->required()->multitoken()->value_name("<num cores> [<num cores> ...]"),
+             "The total numbers of cores (one report per platform and number of cores)\n")
+            ("parallel_fraction", po::value<double>(&parallel_fraction)->default_value(1.0)->value_name("<fraction>"),
+             "Parallel fraction of the work of multi-core tasks, whose speedup follows Amdahl's law\n")
+            ("relative_step", po::value<double>(&relative_step)->default_value(0.01)->value_name("<fraction>"),
+             "Relative perturbation of the task execution time and I/O bandwidths (the number of cores being perturbed by one node)\n")
+            ("num_threads", po::value<unsigned long>(&num_threads)->default_value(1)->value_name("<num threads>"),
+             "Number of threads estimating the perturbed configurations")
+            ;
+
+    po::variables_map vm;
+    std::vector<struct platform_spec> specs;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        if (vm.count("help")) {
+            std::cerr << desc << "\n";
+            exit(0);
+        }
+        po::notify(vm);
+        for (auto const &platform_spec : s_platform_specs) {
+            specs.push_back(parse_platform_spec(platform_spec));
+        }
+        if ((parallel_fraction < 0.0) or (parallel_fraction > 1.0)) {
+            throw std::invalid_argument("the parallel fraction must be between 0 and 1");
+        }
+        if (std::find(num_cores.begin(), num_cores.end(), 0) != num_cores.end()) {
+            throw std::invalid_argument("the number of cores must be > 0");
+        }
+        if ((relative_step <= 0.0) or (relative_step >= 1.0)) {
+            throw std::invalid_argument("the relative step must be between 0 and 1");
+        }
+        num_threads = std::max<unsigned long>(1, num_threads);
+    } catch (std::exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        exit(1);
     }
-    return makespan;
+
+    /* Summarize the workflow once: all perturbed configurations are estimated on the same summary */
+    WorkflowSummary summary;
+    try {
+        std::unordered_map<std::string, struct task_attributes> task_attributes;
+        auto workflow = WfCommonsWorkflowParser::createWorkflowFromJSON(workflow_file, 1.0, false, &task_attributes);
+        summary = WorkflowSummary::createFromWorkflow(workflow, &task_attributes);
+    } catch (std::invalid_argument &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        exit(1);
+    }
+    auto estimators = EstimatorRegistry::getEstimators();
+
+    for (unsigned long s = 0; s < specs.size(); s++) {
+        for (auto const &n : num_cores) {
+            struct platform_config config = make_platform_config(specs[s], specs[s].cpu_task_execution_time, n);
+            config.parallel_fraction = parallel_fraction;
+            auto configs = SensitivityAnalysis::getPerturbedConfigs(config, relative_step);
+            configs.insert(configs.begin(), config);
+
+            printf("PLATFORM %s, %lu CORES (%lu NODES)\n", s_platform_specs[s].c_str(),
+                   config.num_nodes * config.num_cores_per_node, config.num_nodes);
+            printf("  %-12s %14s %8s %8s %8s %8s  %s\n", "estimator", "makespan", "cpu", "read", "write", "cores",
+                   "bottlenecks");
+            for (auto const &estimator : estimators) {
+                auto makespans = estimator->estimateBatch(summary, configs, num_threads);
+                auto sensitivity = SensitivityAnalysis::computeSensitivity(config, relative_step, makespans[0],
+                                                                           makespans.data() + 1);
+                printf("  %-12s %14.1lf %8.3lf %8.3lf %8.3lf %8.3lf  %s\n", estimator->getName().c_str(),
+                       sensitivity.makespan, sensitivity.elasticities[TASK_EXECUTION_TIME],
+                       sensitivity.elasticities[IO_READ_SPEED], sensitivity.elasticities[IO_WRITE_SPEED],
+                       sensitivity.elasticities[NUM_CORES], format_bottlenecks(sensitivity).c_str());
+            }
+
+            /* Per-level report of the critical path estimate (whose makespan is the sum of the levels') */
+            auto levels = SensitivityAnalysis::analyzeLevels(summary, config, relative_step, num_threads);
+            double total = 0.0;
+            for (auto const &level : levels) {
+                total += level.makespan;
+            }
+            printf("  %-6s %10s %14s %7s %8s %8s %8s %8s  %s\n", "level", "tasks", "makespan", "share", "cpu",
+                   "read", "write", "cores", "bottlenecks");
+            for (unsigned long l = 0; l < levels.size(); l++) {
+                printf("  %-6lu %10lu %14.1lf %6.1lf%% %8.3lf %8.3lf %8.3lf %8.3lf  %s\n", l,
+                       summary.getLevelWidth(l), levels[l].makespan, total > 0.0 ? 100.0 * levels[l].makespan / total : 0.0,
+                       levels[l].elasticities[TASK_EXECUTION_TIME], levels[l].elasticities[IO_READ_SPEED],
+                       levels[l].elasticities[IO_WRITE_SPEED], levels[l].elasticities[NUM_CORES],
+                       format_bottlenecks(levels[l]).c_str());
+            }
+            printf("\n");
+        }
+    }
+    return 0;
 }
 
-double estimate_makespan_level(std::vector<std::shared_ptr<wrench::WorkflowTask>> tasks,
-                               unsigned long num_nodes,
-                               unsigned long num_cores_per_node,
-                               double io_read_speed_per_node,
-                               double io_write_speed_per_node) {
-
-    // Sort the vector of tasks according to task makespans
-    std::sort(tasks.begin(), tasks.end(),
-              [io_read_speed_per_node, io_write_speed_per_node]
-                      (const std::shared_ptr<wrench::WorkflowTask> & a, const std::shared_ptr<wrench::WorkflowTask> & b) -> bool
-              {
-                  double makespan_a = compute_task_makespan(a, io_read_speed_per_node, io_write_speed_per_node);
-                  double makespan_b = compute_task_makespan(b, io_read_speed_per_node, io_write_speed_per_node);
-                  return makespan_a > makespan_b;
-              });
-
-    // Go through batches of tasks
-    double level_makespan = 0.0;
-    int num_batches = (int)(std::ceil((double) tasks.size() / ((double)num_nodes * (double)num_cores_per_node)));
-    for (int i = 0; i < num_batches; i++) {
-        int first_task = i * (int)num_nodes * (int)num_cores_per_node;
-        int last_task = std::min<int>((int)tasks.size() - 1, (i+1) * (int)num_nodes * (int)num_cores_per_node - 1);
-        int num_tasks = last_task - first_task + 1;
-        double io_contention = ((double)num_tasks / (double)num_nodes);
-        double sum_task_makespans = 0;
-        for (int t = first_task; t <= last_task; t++) {
-            sum_task_makespans += compute_task_makespan(tasks.at(t), io_read_speed_per_node / io_contention,
-                                                        io_write_speed_per_node / io_contention);
-        }
-        level_makespan += sum_task_makespans / num_tasks; // average task run time accounting for contention
-    }
-
-    return level_makespan;
+/**
+ * @brief The main function of the "ensemble" subcommand, which estimates the makespan of an ensemble of
+ *        workflows that run concurrently on the same allocation, and the completion time of each workflow
+ *
+ * @param argc: argument count
+ * @param argv: argument array (argv[0] being the subcommand)
+ * @return 0 on success, non-zero otherwise
+ */
+int main_ensemble(int argc, char **argv) {
+
+    /* Create a WRENCH simulation object (to create the workflows) */
+    auto simulation = wrench::Simulation::createSimulation();
+    simulation->init(&argc, argv);
+
+    std::vector<std::string> workflow_files;
+    std::string workflow_list;
+    std::vector<double> priorities;
+    std::string s_policy;
+    std::vector<std::string> s_platform_specs;
+    std::vector<unsigned long> num_cores;
+    double parallel_fraction;
+    unsigned long num_threads;
+    std::string output_file;
+    std::string output_format;
+
+    po::options_description desc("Allowed options (ensemble)", 100);
+    desc.add_options()
+            ("help",
+             "Show this help message\n")
+            ("workflows", po::value<std::vector<std::string>>(&workflow_files)->multitoken()->value_name("<path> [<path> ...]"),
+             "Paths to the JSON workflow description files of the ensemble\n")
+            ("workflow_list", po::value<std::string>(&workflow_list)->value_name("<path>"),
+             "Path to a file with one workflow of the ensemble per line: the path to its JSON workflow description file, optionally followed by its priority\n")
+            ("priorities", po::value<std::vector<double>>(&priorities)->multitoken()->value_name("<priority> [<priority> ...]"),
+             "Priorities of the workflows given with --workflows (the higher, the earlier; by default, workflows have decreasing priorities in the order in which they are given)\n")
+            ("policy", po::value<std::string>(&s_policy)->default_value("fair_share")->value_name("<fair_share | priority>"),
+             "How workflows share the allocation: fair_share (the tasks of a level of all workflows are batched together) or priority (the tasks of the workflows with the highest priorities run first)\n")
+            ("platform_spec", po::value<std::vector<std::string>>(&s_platform_specs)->required()->value_name("<cpu_task_exec_time:mem_task_exec_time:per_node_io_read_bw:per_node_io_write_bw:num_cores_per_nodes | name>"),
+             "Possible values:\n\t- specific values, e.g., 200:300:100MBps:80kbps:16\n\t- Summit\n\t- Piz Daint\n")
+            ("num_cores", po::value<std::vector<unsigned long>>(&num_cores)->required()->multitoken()->value_name("<num cores> [<num cores> ...]"),
+             "The total numbers of cores of the allocation\n")
+            ("parallel_fraction", po::value<double>(&parallel_fraction)->default_value(1.0)->value_name("<fraction>"),
+             "Parallel fraction of the work of multi-core tasks, whose speedup follows Amdahl's law\n")
+            ("num_threads", po::value<unsigned long>(&num_threads)->default_value(std::max<unsigned long>(1, std::thread::hardware_concurrency()))->value_name("<num threads>"),
+             "Number of threads estimating configurations\n")
+            ("output", po::value<std::string>(&output_file)->default_value("-")->value_name("<path>"),
+             "Path to the output file (\"-\" for stdout)\n")
+            ("output_format", po::value<std::string>(&output_format)->default_value("csv")->value_name("<csv | jsonl | binary>"),
+             "Format of the output file")
+            ;
+
+    po::variables_map vm;
+    std::vector<struct platform_spec> specs;
+    enum ensemble_policy policy;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        if (vm.count("help")) {
+            std::cerr << desc << "\n";
+            exit(0);
+        }
+        po::notify(vm);
+        for (auto const &platform_spec : s_platform_specs) {
+            specs.push_back(parse_platform_spec(platform_spec));
+        }
+        policy = EnsembleEstimator::parsePolicy(s_policy);
+        if ((parallel_fraction < 0.0) or (parallel_fraction > 1.0)) {
+            throw std::invalid_argument("the parallel fraction must be between 0 and 1");
+        }
+        if (std::find(num_cores.begin(), num_cores.end(), 0) != num_cores.end()) {
+            throw std::invalid_argument("the number of cores must be > 0");
+        }
+        if ((not priorities.empty()) and (priorities.size() != workflow_files.size())) {
+            throw std::invalid_argument("there must be one priority per workflow given with --workflows");
+        }
+        for (unsigned long m = priorities.size(); m < workflow_files.size(); m++) {
+            priorities.push_back(-(double)m);
+        }
+        if (not workflow_list.empty()) {
+            std::ifstream list(workflow_list);
+            if (not list) {
+                throw std::invalid_argument("cannot open " + workflow_list);
+            }
+            std::string line;
+            while (std::getline(list, line)) {
+                std::vector<std::string> tokens;
+                boost::algorithm::trim(line);
+                if (line.empty()) {
+                    continue;
+                }
+                boost::split(tokens, line, boost::is_any_of(" \t"), boost::token_compress_on);
+                workflow_files.push_back(tokens.at(0));
+                priorities.push_back(tokens.size() > 1 ? std::stod(tokens.at(1)) : -(double)priorities.size());
+            }
+        }
+        if (workflow_files.empty()) {
+            throw std::invalid_argument("no workflows (--workflows or --workflow_list is required)");
+        }
+        num_threads = std::max<unsigned long>(1, num_threads);
+    } catch (std::exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        exit(1);
+    }
+
+    /* Summarize the workflows one at a time (with distinct files), and merge them */
+    WorkflowSummary ensemble;
+    std::vector<std::tuple<std::string, long, long>> labels;
+    try {
+        std::vector<WorkflowSummary> summaries;
+        for (unsigned long m = 0; m < workflow_files.size(); m++) {
+            std::unordered_map<std::string, struct task_attributes> task_attributes;
+            auto workflow = WfCommonsWorkflowParser::createWorkflowFromJSON(workflow_files[m], 1.0, false, &task_attributes,
+                                                                            nullptr, std::to_string(m) + "/");
+            summaries.push_back(WorkflowSummary::createFromWorkflow(workflow, &task_attributes));
+            std::string app;
+            long num_tasks_label, data_size_label;
+            get_workflow_labels(workflow_files[m], summaries.back().getNumTasks(), app, num_tasks_label, data_size_label);
+            labels.emplace_back(app, num_tasks_label, data_size_label);
+        }
+        ensemble = WorkflowSummary::createUnion(summaries);
+    } catch (std::invalid_argument &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        exit(1);
+    }
+    fprintf(stderr, "ENSEMBLE OF %lu WORKFLOWS: %lu TASKS IN %lu LEVELS\n",
+            ensemble.num_members, ensemble.getNumTasks(), ensemble.getNumLevels());
+
+    std::vector<struct result_column> schema = {
+            {"app", column_type::STRING},
+            {"num_tasks", column_type::INTEGER},
+            {"data_size", column_type::INTEGER},
+            {"workflow", column_type::INTEGER},
+            {"priority", column_type::REAL},
+            {"policy", column_type::STRING},
+            {"machine", column_type::STRING},
+            {"num_cores", column_type::INTEGER},
+            {"completion_time", column_type::REAL}};
+    std::unique_ptr<ResultWriter> writer;
+    try {
+        writer = ResultWriter::createResultWriter(output_format, output_file, schema);
+    } catch (std::invalid_argument &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        exit(1);
+    }
+
+    auto estimators = EstimatorRegistry::getEstimators();
+    for (unsigned long s = 0; s < specs.size(); s++) {
+        std::vector<struct platform_config> configs;
+        for (auto const &n : num_cores) {
+            configs.push_back(make_platform_config(specs[s], specs[s].cpu_task_execution_time, n));
+            configs.back().parallel_fraction = parallel_fraction;
+        }
+
+        // Estimates of the whole ensemble, as a single workflow
+        std::vector<std::vector<double>> estimates;
+        for (auto const &e : estimators) {
+            estimates.push_back(e->estimateBatch(ensemble, configs, num_threads));
+        }
+
+        // Completion times, each thread taking the next configuration
+        std::vector<struct ensemble_estimate> ensemble_estimates(configs.size());
+        std::atomic<unsigned long> next(0);
+        auto estimate = [&]() {
+            EstimationWorkspace workspace(ensemble);
+            for (unsigned long c = next++; c < configs.size(); c = next++) {
+                ensemble_estimates[c] = EnsembleEstimator::estimate(ensemble, configs[c], policy, priorities, workspace);
+            }
+        };
+        std::vector<std::thread> workers;
+        for (unsigned long t = 1; t < std::min<unsigned long>(num_threads, configs.size()); t++) {
+            workers.emplace_back(estimate);
+        }
+        estimate();
+        for (auto &w : workers) {
+            w.join();
+        }
+
+        for (unsigned long c = 0; c < configs.size(); c++) {
+            fprintf(stderr, "PLATFORM %s, %lu CORES:\n", s_platform_specs[s].c_str(), num_cores[c]);
+            for (unsigned long e = 0; e < estimators.size(); e++) {
+                fprintf(stderr, "%-22s: %.1lf seconds\n",
+                        boost::to_upper_copy(estimators[e]->getDescription()).c_str(), estimates[e][c]);
+            }
+            fprintf(stderr, "%-22s: %.1lf seconds\n\n", boost::to_upper_copy(s_policy).c_str(), ensemble_estimates[c].makespan);
+
+            for (unsigned long m = 0; m < workflow_files.size(); m++) {
+                writer->addString(std::get<0>(labels[m]));
+                writer->addInteger(std::get<1>(labels[m]));
+                writer->addInteger(std::get<2>(labels[m]));
+                writer->addInteger((long)m);
+                writer->addReal(priorities[m]);
+                writer->addString(s_policy);
+                writer->addString(s_platform_specs[s]);
+                writer->addInteger((long)num_cores[c]);
+                writer->addReal(ensemble_estimates[c].completion_times[m]);
+                writer->endRow();
+            }
+        }
+    }
+    writer->close();
+    return 0;
 }
 
-double estimate_makespan_critical_path(const std::shared_ptr<wrench::Workflow>& workflow,
-                                       unsigned long num_nodes,
-                                       unsigned long num_cores_per_node,
-                                       double io_read_speed_per_node,
-                                       double io_write_speed_per_node) {
+/**
+ * @brief The main function of the "calibrate" subcommand, which fits the task execution time, per-node I/O
+ *        bandwidths, and I/O contention exponent of a machine to its measured makespans
+ *
+ * @param argc: argument count
+ * @param argv: argument array (argv[0] being the subcommand)
+ * @return 0 on success, non-zero otherwise
+ */
+int main_calibrate(int argc, char **argv) {
+
+    /* Create a WRENCH simulation object (to create the workflows) */
+    auto simulation = wrench::Simulation::createSimulation();
+    simulation->init(&argc, argv);
+
+    std::string real_file;
+    std::vector<std::string> workflow_files;
+    std::string workflow_list;
+    std::string machine;
+    std::string s_platform_spec;
+    std::string task_type;
+    unsigned long num_cores;
+    std::string estimator_name;
+    double parallel_fraction;
+    struct calibration_spec spec{};
+
+    po::options_description desc("Allowed options (calibrate)", 100);
+    desc.add_options()
+            ("help",
+             "Show this help message\n")
+            ("real", po::value<std::string>(&real_file)->required()->value_name("<path>"),
+             "Path to the measured makespans (CSV with columns app,num_tasks,data_size,type,makespan,machine, and optionally num_cores)\n")
+            ("workflows", po::value<std::vector<std::string>>(&workflow_files)->multitoken()->value_name("<path> [<path> ...]"),
+             "Paths to the JSON workflow description files of the measured runs, whose file names give their labels (e.g., blast-200-1000.json)\n")
+            ("workflow_list", po::value<std::string>(&workflow_list)->value_name("<path>"),
+             "Path to a file with the path to a JSON workflow description file per line\n")
+            ("machine", po::value<std::string>(&machine)->required()->value_name("<name>"),
+             "Machine whose measured makespans are fitted\n")
+            ("platform_spec", po::value<std::string>(&s_platform_spec)->value_name("<cpu_task_exec_time:mem_task_exec_time:per_node_io_read_bw:per_node_io_write_bw:num_cores_per_nodes | name>"),
+             "Initial platform specification, which also gives the number of cores per node (default: the machine name)\n")
+            ("type", po::value<std::string>(&task_type)->default_value("cpu")->value_name("<cpu | mem>"),
+             "Task type of the measured makespans to fit\n")
+            ("num_cores", po::value<unsigned long>(&num_cores)->default_value(0)->value_name("<num cores>"),
+             "Total number of cores of the measured runs (required unless the measured makespans have a num_cores column)\n")
+            ("estimator", po::value<std::string>(&estimator_name)->default_value("estimate3")->value_name("<name>"),
+             "Name of the estimator whose estimates are fitted\n")
+            ("parallel_fraction", po::value<double>(&parallel_fraction)->default_value(1.0)->value_name("<fraction>"),
+             "Parallel fraction of the work of multi-core tasks, whose speedup follows Amdahl's law\n")
+            ("group_tasks",
+             "Estimate on groups of identical tasks (same category, work, and data sizes) in each level\n")
+            ("num_starts", po::value<unsigned long>(&spec.num_starts)->default_value(16)->value_name("<num starts>"),
+             "Number of starting points of the fit (the initial parameters, and random points around them)\n")
+            ("spread", po::value<double>(&spec.spread)->default_value(10.0)->value_name("<factor>"),
+             "Largest factor between the task execution time and bandwidths of a random starting point and the initial ones\n")
+            ("max_iterations", po::value<unsigned long>(&spec.max_iterations)->default_value(100)->value_name("<num iterations>"),
+             "Maximum number of Levenberg-Marquardt iterations per starting point\n")
+            ("seed", po::value<unsigned long>(&spec.seed)->default_value(0)->value_name("<seed>"),
+             "Seed of the random starting points\n")
+            ("num_threads", po::value<unsigned long>(&spec.num_threads)->default_value(std::max<unsigned long>(1, std::thread::hardware_concurrency()))->value_name("<num threads>"),
+             "Number of threads fitting starting points")
+            ;
+
+    po::variables_map vm;
+    struct platform_spec platform;
+    std::shared_ptr<MakespanEstimator> estimator;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        if (vm.count("help")) {
+            std::cerr << desc << "\n";
+            exit(0);
+        }
+        po::notify(vm);
+        platform = parse_platform_spec(s_platform_spec.empty() ? machine : s_platform_spec);
+        estimator = EstimatorRegistry::getEstimator(estimator_name);
+        if ((task_type != "cpu") and (task_type != "mem")) {
+            throw std::invalid_argument("unknown task type " + task_type + " (expected cpu or mem)");
+        }
+        if ((parallel_fraction < 0.0) or (parallel_fraction > 1.0)) {
+            throw std::invalid_argument("the parallel fraction must be between 0 and 1");
+        }
+        if ((not vm["num_cores"].defaulted()) and (num_cores == 0)) {
+            throw std::invalid_argument("the number of cores must be > 0");
+        }
+        if (not workflow_list.empty()) {
+            std::ifstream list(workflow_list);
+            if (not list) {
+                throw std::invalid_argument("cannot open " + workflow_list);
+            }
+            std::string line;
+            while (std::getline(list, line)) {
+                boost::algorithm::trim(line);
+                if (not line.empty()) {
+                    workflow_files.push_back(line);
+                }
+            }
+        }
+        if (workflow_files.empty()) {
+            throw std::invalid_argument("no workflows (--workflows or --workflow_list is required)");
+        }
+    } catch (std::exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        exit(1);
+    }
+
+    /* Summarize each workflow once (with distinct files): all objective evaluations estimate these summaries */
+    std::vector<WorkflowSummary> summaries;
+    std::vector<struct calibration_observation> observations;
+    try {
+        auto real = ResultReader::readResults(real_file);
+        std::vector<std::tuple<std::string, long, long>> labels;
+        for (unsigned long w = 0; w < workflow_files.size(); w++) {
+            std::unordered_map<std::string, struct task_attributes> task_attributes;
+            auto workflow = WfCommonsWorkflowParser::createWorkflowFromJSON(workflow_files[w], 1.0, false, &task_attributes,
+                                                                            nullptr, std::to_string(w) + "/");
+            auto summary = WorkflowSummary::createFromWorkflow(workflow, &task_attributes);
+            std::string app;
+            long num_tasks_label, data_size_label;
+            get_workflow_labels(workflow_files[w], summary.getNumTasks(), app, num_tasks_label, data_size_label);
+            labels.emplace_back(app, num_tasks_label, data_size_label);
+            summaries.push_back(vm.count("group_tasks") ? WorkflowSummary::createGrouped(summary) : summary);
+        }
+        observations = PlatformCalibration::getObservations(real, machine, task_type, labels, num_cores);
+        if (observations.empty()) {
+            throw std::invalid_argument("no measured makespans of " + task_type + " workflows on " + machine +
+                                        " for the given workflows");
+        }
+    } catch (std::invalid_argument &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        exit(1);
+    }
 
-    double makespan = 0.0;
-    for (int i = 0; i < workflow->getNumLevels(); i++) {
-        makespan += estimate_makespan_level(workflow->getTasksInTopLevelRange(i,i),
-                                            num_nodes, num_cores_per_node,
-                                            io_read_speed_per_node, io_write_speed_per_node);
+    struct platform_config initial_config = make_platform_config(platform, task_type == "cpu" ? platform.cpu_task_execution_time :
+                                                                                         platform.mem_task_execution_time,
+                                                                 platform.num_cores_per_node);
+    initial_config.parallel_fraction = parallel_fraction;
+    struct calibration_result result;
+    try {
+        result = PlatformCalibration::calibrate(summaries, observations, *estimator, initial_config, spec);
+    } catch (std::invalid_argument &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        exit(1);
     }
-    return makespan;
+
+    auto const &fitted = result.config;
+    printf("MACHINE %s: %lu MEASURED MAKESPANS, %s ESTIMATES (%lu STARTING POINTS, %lu EVALUATIONS)\n",
+           machine.c_str(), observations.size(), estimator->getName().c_str(), spec.num_starts, result.num_evaluations);
+    printf("  %-26s %14s %14s\n", "parameter", "initial", "fitted");
+    printf("  %-26s %14.3lf %14.3lf\n", "task execution time (sec)", initial_config.task_execution_time, fitted.task_execution_time);
+    printf("  %-26s %14.2lf %14.2lf\n", "read bandwidth (MB/sec)", initial_config.io_read_speed_per_node / MBYTE,
+           fitted.io_read_speed_per_node / MBYTE);
+    printf("  %-26s %14.2lf %14.2lf\n", "write bandwidth (MB/sec)", initial_config.io_write_speed_per_node / MBYTE,
+           fitted.io_write_speed_per_node / MBYTE);
+    printf("  %-26s %14.3lf %14.3lf\n", "contention exponent", initial_config.io_contention_exponent, fitted.io_contention_exponent);
+    printf("  %-26s %13.2lf%% %13.2lf%%\n", "rms relative error", 100.0 * result.initial_error, 100.0 * result.error);
+    printf("  %-26s %14s %13.2lf%%\n", "max relative error", "", 100.0 * result.max_relative_error);
+
+    /* The fitted platform specification, as a --platform_spec value */
+    printf("PLATFORM SPEC: %.17g:%.17g:%.17gBps:%.17gBps:%u:%.17gB:%.17gBps:%.17gBps:%.17gBps:%.17g:%.17gBps:%.17g\n",
+           task_type == "cpu" ? fitted.task_execution_time : platform.cpu_task_execution_time,
+           task_type == "mem" ? fitted.task_execution_time : platform.mem_task_execution_time,
+           fitted.io_read_speed_per_node, fitted.io_write_speed_per_node, platform.num_cores_per_node,
+           platform.page_cache_size_per_node, platform.local_read_speed_per_node, platform.local_write_speed_per_node,
+           platform.network_bandwidth_per_node, platform.network_latency, platform.bisection_bandwidth,
+           fitted.io_contention_exponent);
+    return 0;
 }
 
 /**
@@ -187,6 +911,26 @@ double estimate_makespan_critical_path(const std::shared_ptr<wrench::Workflow>&
  */
 int main(int argc, char **argv) {
 
+    /* Subcommands */
+    if ((argc > 1) and (std::string(argv[1]) == "evaluate")) {
+        return main_evaluate(argc - 1, argv + 1);
+    }
+    if ((argc > 1) and (std::string(argv[1]) == "benchmark")) {
+        return main_benchmark(argc - 1, argv + 1);
+    }
+    if ((argc > 1) and (std::string(argv[1]) == "simulate")) {
+        return main_simulate(argc - 1, argv + 1);
+    }
+    if ((argc > 1) and (std::string(argv[1]) == "sensitivity")) {
+        return main_sensitivity(argc - 1, argv + 1);
+    }
+    if ((argc > 1) and (std::string(argv[1]) == "ensemble")) {
+        return main_ensemble(argc - 1, argv + 1);
+    }
+    if ((argc > 1) and (std::string(argv[1]) == "calibrate")) {
+        return main_calibrate(argc - 1, argv + 1);
+    }
+
     /* Create a WRENCH simulation object */
     auto simulation = wrench::Simulation::createSimulation();
 
@@ -196,7 +940,20 @@ int main(int argc, char **argv) {
     std::string workflow_file;
     std::string s_flops_per_unit_of_cpu_work;
     std::string s_task_type;
-    int num_cores;
+    std::vector<unsigned long> num_cores;
+    struct monte_carlo_spec mc_spec{};
+    double parallel_fraction;
+    double deadline;
+    double max_core_hours;
+    unsigned long max_num_cores;
+    std::string output_file;
+    std::string output_format;
+    std::string profile_file;
+    std::string profile_format;
+    std::vector<std::string> estimator_names;
+    std::string spill_directory;
+    std::string cache_file;
+    std::vector<std::string> s_overlaps;
 
     std::vector<std::string> s_platform_specs;
 
@@ -210,8 +967,60 @@ int main(int argc, char **argv) {
              "Path to JSON workflow description file\n")
             ("platform_spec", po::value<std::vector<std::string>>(&s_platform_specs)->required()->value_name("<cpu_task_exec_time:mem_task_exec_time:per_node_io_read_bw:per_node_io_write_bw:num_cores_per_nodes | name>"),
              "Possible values:\n\t- specific values, e.g., 200:300:100MBps:80kbps:16\n\t- Summit\n\t- Piz Daint\n")
-            ("num_cores", po::value<int>(&num_cores)->required()->value_name("<num cores>"),
-             "The total number of cores")
+            ("num_cores", po::value<std::vector<unsigned long>>(&num_cores)->multitoken()->value_name("<num cores> [<num cores> ...]"),
+             "The total number of cores (several values can be given to sweep over core counts), required unless --deadline is given\n")
+            ("deadline", po::value<double>(&deadline)->default_value(0)->value_name("<seconds>"),
+             "Search for the smallest number of cores whose critical path estimate meets this deadline, and output the makespan-vs-cores Pareto front instead of given core counts (0: no search)\n")
+            ("max_core_hours", po::value<double>(&max_core_hours)->default_value(0)->value_name("<core hours>"),
+             "With --deadline, also require the core hours (number of cores * estimate) to be at most this value (0: no limit)\n")
+            ("max_num_cores", po::value<unsigned long>(&max_num_cores)->default_value(0)->value_name("<num cores>"),
+             "With --deadline, the largest number of cores to consider (0: enough cores to run the widest level in a single batch)\n")
+            ("parallel_fraction", po::value<double>(&parallel_fraction)->default_value(1.0)->value_name("<fraction>"),
+             "Parallel fraction of the work of multi-core tasks, whose speedup follows Amdahl's law\n")
+            ("monte_carlo_replicas", po::value<unsigned long>(&mc_spec.num_replicas)->default_value(0)->value_name("<num replicas>"),
+             "Number of Monte Carlo replicas with sampled platform parameters (0: no Monte Carlo)\n")
+            ("cv_task_execution_time", po::value<double>(&mc_spec.cv_task_execution_time)->default_value(0.1)->value_name("<cv>"),
+             "Coefficient of variation of the task execution time (Monte Carlo only)\n")
+            ("cv_io_read_speed", po::value<double>(&mc_spec.cv_io_read_speed)->default_value(0.1)->value_name("<cv>"),
+             "Coefficient of variation of the per-node I/O read bandwidth (Monte Carlo only)\n")
+            ("cv_io_write_speed", po::value<double>(&mc_spec.cv_io_write_speed)->default_value(0.1)->value_name("<cv>"),
+             "Coefficient of variation of the per-node I/O write bandwidth (Monte Carlo only)\n")
+            ("num_threads", po::value<unsigned long>(&mc_spec.num_threads)->default_value(std::max<unsigned long>(1, std::thread::hardware_concurrency()))->value_name("<num threads>"),
+             "Number of threads used to estimate levels and to run Monte Carlo replicas\n")
+            ("seed", po::value<unsigned long>(&mc_spec.seed)->default_value(42)->value_name("<seed>"),
+             "Seed of the Monte Carlo random number generators\n")
+            ("output", po::value<std::string>(&output_file)->default_value("-")->value_name("<path>"),
+             "Path to the result file (\"-\" for stdout)\n")
+            ("output_format", po::value<std::string>(&output_format)->default_value("csv")->value_name("<csv | jsonl | binary>"),
+             "Format of the result file\n")
+            ("profile", po::value<std::string>(&profile_file)->value_name("<path>"),
+             "Path to a level profile file, with one row per (platform, core count, level) of the critical path estimate: its start time, makespan, number of tasks and batches, compute and I/O time shares, core utilization, idle cores in its last batch, and I/O contention\n")
+            ("profile_format", po::value<std::string>(&profile_format)->default_value("csv")->value_name("<csv | jsonl | binary>"),
+             "Format of the level profile file\n")
+            ("overlap", po::value<std::vector<std::string>>(&s_overlaps)->multitoken()->value_name("<category:factor> [<category:factor> ...]"),
+             "Overlap factors (between 0 and 1) of the I/O and computation of tasks of a category (\"*\" for all other categories), a task's overlap being its category's factor times its CPU-bound fraction (--percent-cpu of wfbench tasks, 1 otherwise): 0 for tasks that read, compute, and write in sequence, 1 for fully pipelined tasks\n")
+            ("page_cache",
+             "Account for per-node page caches, from which input files shared by several tasks of a level are read after the first read on a node (the page cache size is part of the platform specification string, as it is not measured for named platforms)\n")
+            ("staging",
+             "Stage intermediate files (produced and consumed by workflow tasks) on node-local storage, whose bandwidths are part of the platform specification string, as they are not measured for named platforms\n")
+            ("network",
+             "Place tasks on nodes near the producers of their input files, and transfer intermediate files between nodes over the network (whose per-node bandwidth, latency, and bisection bandwidth are part of the platform specification string, as they are not measured for named platforms) rather than through the shared file system\n")
+            ("group_tasks",
+             "Estimate on groups of identical tasks (same category, work, and data sizes) in each level, which is much faster for large homogeneous workflows\n")
+            ("streaming",
+             "Stream the workflow file level by level from disk rather than loading it in memory, for workflows larger than memory (no bounds, page caches, staging, network, deadline search, Monte Carlo, or plug-in estimators)\n")
+            ("spill_directory", po::value<std::string>(&spill_directory)->default_value(std::filesystem::temp_directory_path().string())->value_name("<path>"),
+             "Directory of the temporary files of --streaming\n")
+            ("cache", po::value<std::string>(&cache_file)->value_name("<path>"),
+             "Path to a cache file of estimates, created if needed and shared by concurrent runs, so that the estimates of a workflow file for a platform are only computed once (Monte Carlo percentiles and deadline searches are not cached)\n")
+            ("estimators", po::value<std::vector<std::string>>(&estimator_names)->multitoken()->value_name("<name> [<name> ...]"),
+             "Names of the estimators to run, which are also the names of their result columns (default: all available estimators)\n")
+            ("plugin", po::value<std::vector<std::string>>()->value_name("<path>"),
+             "Path to an estimator plug-in (a shared object exporting register_makespan_estimators()), which can be given several times\n")
+            ("list_estimators",
+             "List the available estimators (including those of plug-ins) and exit\n")
+            ("quiet",
+             "Do not print the human-readable report on stderr")
             ;
 
     // Parse command-line arguments
@@ -223,6 +1032,18 @@ int main(int argc, char **argv) {
             std::cerr << desc << "\n";
             exit(0);
         }
+        // Load plug-ins, and list estimators if needed
+        if (vm.count("plugin")) {
+            for (auto const &path : vm["plugin"].as<std::vector<std::string>>()) {
+                EstimatorRegistry::loadPlugin(path);
+            }
+        }
+        if (vm.count("list_estimators")) {
+            for (auto const &e : EstimatorRegistry::getEstimators()) {
+                fprintf(stdout, "%s: %s\n", e->getName().c_str(), e->getDescription().c_str());
+            }
+            exit(0);
+        }
         // Throw whatever exception in case argument values are erroneous
         po::notify(vm);
     } catch (std::exception &e) {
@@ -231,95 +1052,535 @@ int main(int argc, char **argv) {
     }
 
 
-    /* Create the workflow */
-    auto workflow = WfCommonsWorkflowParser::createWorkflowFromJSON(workflow_file, 1.0, false);
+    if (num_cores.empty() and (deadline <= 0)) {
+        std::cerr << "Error: --num_cores is required unless --deadline is given\n";
+        exit(1);
+    }
+    if (std::find(num_cores.begin(), num_cores.end(), 0) != num_cores.end()) {
+        std::cerr << "Error: the number of cores must be > 0\n";
+        exit(1);
+    }
+    if ((parallel_fraction < 0.0) or (parallel_fraction > 1.0)) {
+        std::cerr << "Error: the parallel fraction must be between 0 and 1\n";
+        exit(1);
+    }
+    std::unordered_map<std::string, double> overlaps;
+    for (auto const &s_overlap : s_overlaps) {
+        auto separator = s_overlap.find_last_of(':');
+        double factor = -1.0;
+        try {
+            factor = separator == std::string::npos ? -1.0 : std::stod(s_overlap.substr(separator + 1));
+        } catch (std::exception &e) {
+        }
+        if ((factor < 0.0) or (factor > 1.0)) {
+            std::cerr << "Error: invalid overlap " << s_overlap << " (expected <category>:<factor between 0 and 1>)\n";
+            exit(1);
+        }
+        overlaps[s_overlap.substr(0, separator)] = factor;
+    }
+    std::string overlaps_key;
+    for (auto const &o : std::map<std::string, double>(overlaps.begin(), overlaps.end())) {
+        char factor[32];
+        snprintf(factor, sizeof(factor), "%.17g", o.second);
+        overlaps_key += o.first + ":" + factor + ",";
+    }
+    std::vector<std::shared_ptr<MakespanEstimator>> estimators;
+    try {
+        if (estimator_names.empty()) {
+            estimators = EstimatorRegistry::getEstimators();
+        }
+        for (auto const &name : estimator_names) {
+            estimators.push_back(EstimatorRegistry::getEstimator(name));
+        }
+    } catch (std::invalid_argument &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        exit(1);
+    }
 
+    bool page_cache = vm.count("page_cache");
+    bool group_tasks = vm.count("group_tasks");
+    bool staging = vm.count("staging");
+    bool network = vm.count("network");
+    bool quiet = vm.count("quiet");
+    bool streaming = vm.count("streaming");
+    if (network and (page_cache or staging)) {
+        std::cerr << "Error: --network cannot be used with --page_cache or --staging\n";
+        exit(1);
+    }
+    // With page caches or a network, bytes read depend on the number of nodes (and the summary on the configuration)
+    bool per_node_summary = page_cache or network;
+    if (streaming) {
+        if (page_cache or staging or network or (deadline > 0) or (mc_spec.num_replicas > 0) or (not overlaps.empty()) or
+            (not profile_file.empty())) {
+            std::cerr << "Error: --streaming cannot be used with --page_cache, --staging, --network, --deadline, --monte_carlo_replicas, --overlap, or --profile\n";
+            exit(1);
+        }
+        for (auto const &e : estimators) {
+            if ((e->getName() != "estimate1") and (e->getName() != "estimate2") and (e->getName() != "estimate3")) {
+                std::cerr << "Error: --streaming only supports the built-in estimators\n";
+                exit(1);
+            }
+        }
+    }
 
-    for (auto const &platform_spec : s_platform_specs) {
+    /* Open the cache, in which a workflow file (path, size, and modification time) that was already loaded
+     * maps to the fingerprint of its contents, under which its totals and estimates are cached */
+    std::unique_ptr<ResultCache> cache;
+    std::string file_key;
+    WorkflowFingerprint fingerprint;
+    bool cached_workflow = false;
+    if (not cache_file.empty()) {
+        try {
+            cache = ResultCache::open(cache_file);
+        } catch (std::invalid_argument &e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            exit(1);
+        }
+        std::error_code ec;
+        auto path = std::filesystem::canonical(workflow_file, ec);
+        auto size = std::filesystem::file_size(path, ec);
+        auto mtime = std::filesystem::last_write_time(path, ec);
+        if (not ec) {
+            file_key = "file|" + path.string() + "|" + std::to_string(size) + "|" +
+                       std::to_string(mtime.time_since_epoch().count());
+            cached_workflow = cache->lookup(file_key + "|low", fingerprint.low) and
+                              cache->lookup(file_key + "|high", fingerprint.high);
+        }
+    }
+    auto fingerprint_key = [&](const std::string &name) -> std::string {
+        return fingerprint.toString() + "|" + name;
+    };
 
-        unsigned long num_cores_per_node;
-        double cpu_task_execution_time;
-        double mem_task_execution_time;
-        double io_read_speed_per_node;
-        double io_write_speed_per_node;
-
-        if (platform_spec.find(':') != string::npos) {
-            std::vector<std::string> tokens;
-            boost::split(tokens, platform_spec, boost::is_any_of(":"));
-            if (tokens.size() != 5) {
-                std::cerr << "Error: invalid platform specification " << platform_spec << "\n";
-                exit(1);
+    /* Create the workflow (with --streaming, the summary only has the workflow's totals). With a cache, the
+     * workflow is only loaded once an estimate is not found in it, and the summary only has the workflow's
+     * cached totals until then */
+    WorkflowSummary summary;
+    std::unique_ptr<StreamingWorkflowReader> stream;
+    bool workflow_loaded = false;
+    auto load_workflow = [&]() {
+        if (workflow_loaded) {
+            return;
+        }
+        try {
+            if (streaming) {
+                stream = StreamingWorkflowReader::createFromJSON(workflow_file, spill_directory);
+                if (not quiet) {
+                    fprintf(stderr, "STREAMED %lu TASKS AND %lu DEPENDENCIES (%lu LEVELS)\n", stream->getNumTasks(),
+                            stream->getNumDependencies(), stream->getNumLevels());
+                }
+                summary = stream->getTotals();
+                fingerprint = stream->getFingerprint();
+            } else {
+                std::unordered_map<std::string, struct task_attributes> task_attributes;
+                fingerprint = WorkflowFingerprint();
+                unsigned long num_removed_dependencies = 0;
+                auto workflow = WfCommonsWorkflowParser::createWorkflowFromJSON(workflow_file, 1.0, false, &task_attributes,
+                                                                                cache ? &fingerprint : nullptr, "",
+                                                                                &num_removed_dependencies);
+                if (not quiet) {
+                    fprintf(stderr, "REMOVED %lu REDUNDANT DEPENDENCIES\n", num_removed_dependencies);
+                }
+                summary = WorkflowSummary::createFromWorkflow(workflow, &task_attributes, overlaps.empty() ? nullptr : &overlaps);
             }
-            cpu_task_execution_time = strtod(tokens.at(0).c_str(), nullptr);
-            mem_task_execution_time = strtod(tokens.at(1).c_str(), nullptr);
-            io_read_speed_per_node = UnitParser::parse_bandwidth(tokens.at(2));
-            io_write_speed_per_node = UnitParser::parse_bandwidth(tokens.at(3));
-            num_cores_per_node = strtoul(tokens.at(4).c_str(), nullptr, 10);
-        } else if (platform_specs.find(platform_spec) != platform_specs.end()) {
-            cpu_task_execution_time = platform_specs[platform_spec].cpu_task_execution_time;
-            mem_task_execution_time = platform_specs[platform_spec].mem_task_execution_time;
-            io_read_speed_per_node = platform_specs[platform_spec].io_read_speed_per_node;
-            io_write_speed_per_node = platform_specs[platform_spec].io_write_speed_per_node;
-            num_cores_per_node = platform_specs[platform_spec].num_cores_per_node;
-        } else {
-            std::cerr << "Error: invalid platform specification " << platform_spec << "\n";
+        } catch (std::invalid_argument &e) {
+            std::cerr << "Error: " << e.what() << "\n";
             exit(1);
         }
+        workflow_loaded = true;
+        // The workflow file is mapped to its fingerprint last, so that its totals are cached once it is
+        if (cache and (not file_key.empty())) {
+            cache->insert(fingerprint_key("num_tasks"), (uint64_t)summary.getNumTasks());
+            cache->insert(fingerprint_key("total_work"), summary.total_work);
+            cache->insert(file_key + "|low", fingerprint.low);
+            cache->insert(file_key + "|high", fingerprint.high);
+        }
+    };
+    uint64_t cached_num_tasks;
+    if (cached_workflow and cache->lookup(fingerprint_key("num_tasks"), cached_num_tasks) and
+        cache->lookup(fingerprint_key("total_work"), summary.total_work)) {
+        summary.num_tasks = cached_num_tasks;
+    } else {
+        cached_workflow = false;
+        load_workflow();
+    }
+
+    /* Create the result writer */
+    std::string app;
+    long num_tasks_label, data_size_label;
+    get_workflow_labels(workflow_file, summary.getNumTasks(), app, num_tasks_label, data_size_label);
+    std::vector<struct result_column> schema = {
+            {"app", column_type::STRING},
+            {"num_tasks", column_type::INTEGER},
+            {"data_size", column_type::INTEGER},
+            {"type", column_type::STRING}};
+    for (auto const &e : estimators) {
+        schema.push_back({e->getName(), column_type::REAL});
+    }
+    schema.insert(schema.end(), {
+            {"machine", column_type::STRING},
+            {"num_cores", column_type::INTEGER}});
+    if (not streaming) {
+        schema.insert(schema.end(), {
+                {"lower_bound", column_type::REAL},
+                {"upper_bound", column_type::REAL}});
+    }
+    // Monte Carlo replicas are run for the (selected) built-in estimators
+    std::vector<int> mc_estimates;
+    for (auto const &e : estimators) {
+        for (int i = 0; i < NUM_ESTIMATES; i++) {
+            if (e->getName() == "estimate" + std::to_string(i + 1)) {
+                mc_estimates.push_back(i);
+            }
+        }
+    }
+    if (mc_spec.num_replicas > 0) {
+        for (auto i : mc_estimates) {
+            for (auto const &p : {"p50", "p90", "p99"}) {
+                schema.push_back({"estimate" + std::to_string(i + 1) + "_" + p, column_type::REAL});
+            }
+        }
+    }
+    std::unique_ptr<ResultWriter> writer;
+    std::unique_ptr<ResultWriter> profile_writer;
+    try {
+        writer = ResultWriter::createResultWriter(output_format, output_file, schema);
+        if (not profile_file.empty()) {
+            profile_writer = ResultWriter::createResultWriter(profile_format, profile_file, {
+                    {"app", column_type::STRING},
+                    {"machine", column_type::STRING},
+                    {"num_cores", column_type::INTEGER},
+                    {"level", column_type::INTEGER},
+                    {"start", column_type::REAL},
+                    {"makespan", column_type::REAL},
+                    {"num_tasks", column_type::INTEGER},
+                    {"num_batches", column_type::INTEGER},
+                    {"compute_share", column_type::REAL},
+                    {"io_share", column_type::REAL},
+                    {"core_utilization", column_type::REAL},
+                    {"idle_cores", column_type::INTEGER},
+                    {"io_contention", column_type::REAL}});
+        }
+    } catch (std::invalid_argument &e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        exit(1);
+    }
+
+    for (auto const &platform_spec : s_platform_specs) {
+
+        struct platform_spec spec{};
+        try {
+            spec = parse_platform_spec(platform_spec);
+        } catch (std::invalid_argument &e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            exit(1);
+        }
+        if (page_cache and (spec.page_cache_size_per_node <= 0)) {
+            std::cerr << "Warning: no page cache size for platform " << platform_spec << " (--page_cache has no effect)\n";
+        }
+        if (staging and ((spec.local_read_speed_per_node <= 0) or (spec.local_write_speed_per_node <= 0))) {
+            std::cerr << "Warning: no local storage bandwidths for platform " << platform_spec << " (--staging has no effect)\n";
+        }
+        if (network and (spec.network_bandwidth_per_node <= 0)) {
+            std::cerr << "Warning: no network bandwidth for platform " << platform_spec << " (--network has no effect)\n";
+        }
 
-//        std::map<std::string, double> task_types = {{"cpu", cpu_task_execution_time}, {"mem", mem_task_execution_time}};
-        std::map<std::string, double> task_types = {{"cpu", cpu_task_execution_time}};
+//        std::map<std::string, double> task_types = {{"cpu", spec.cpu_task_execution_time}, {"mem", spec.mem_task_execution_time}};
+        std::map<std::string, double> task_types = {{"cpu", spec.cpu_task_execution_time}};
         for (auto const &tt : task_types) {
 
             double task_execution_time = tt.second;
+            struct platform_config base_config = make_platform_config(spec, task_execution_time, spec.num_cores_per_node);
+            base_config.parallel_fraction = parallel_fraction;
+
+            // Cache key of a value of a configuration, which covers all that the value depends on
+            auto config_key = [&](const struct platform_config &config, const std::string &name) -> std::string {
+                char key[512];
+                snprintf(key, sizeof(key), "%s|%lu|%lu|%.17g|%.17g|%.17g|%.17g|%.17g|%.17g|%.17g|%.17g|%.17g|%.17g|%.17g|%d%d%d%d%d|",
+                         tt.first.c_str(), config.num_nodes, config.num_cores_per_node, config.task_execution_time,
+                         config.io_read_speed_per_node, config.io_write_speed_per_node, config.page_cache_size_per_node,
+                         config.local_read_speed_per_node, config.local_write_speed_per_node,
+                         config.network_bandwidth_per_node, config.network_latency, config.bisection_bandwidth,
+                         config.io_contention_exponent, config.parallel_fraction, page_cache, staging, network, group_tasks, streaming);
+                return fingerprint_key(key + overlaps_key + "|" + name);
+            };
+            auto estimator_key = [&](const struct platform_config &config, const MakespanEstimator &estimator) -> std::string {
+                return config_key(config, estimator.getName() + "@" + estimator.getVersion());
+            };
+
+            // The workflow is only needed if some estimate of this platform is not cached (the bytes read and
+            // written, which page caches, staging, and the network change, are cached for the report)
+            bool from_cache = cached_workflow and (deadline <= 0) and (mc_spec.num_replicas == 0) and (not profile_writer);
+            for (auto const &n : num_cores) {
+                struct platform_config config = make_platform_config(spec, task_execution_time, n);
+                config.parallel_fraction = parallel_fraction;
+                double value;
+                for (auto const &e : estimators) {
+                    from_cache = from_cache and cache->lookup(estimator_key(config, *e), value);
+                }
+                for (auto const &name : {"total_bytes_read", "total_bytes_written", "lower_bound", "upper_bound"}) {
+                    from_cache = from_cache and (streaming or cache->lookup(config_key(config, name), value));
+                }
+            }
+            if (not from_cache) {
+                load_workflow();
+            }
+
+            // Staging only depends on bandwidths, which are the same for all core counts, and tasks are
+            // grouped once staged (bounds need the non-grouped summary)
+            WorkflowSummary staged_summary;
+            WorkflowSummary grouped_summary;
+            if (staging and not per_node_summary and not from_cache) {
+                staged_summary = WorkflowSummary::createWithStaging(summary, base_config);
+            }
+            const WorkflowSummary &task_summary = (staging and not per_node_summary) ? staged_summary : summary;
+            if (group_tasks and not per_node_summary and not streaming and not from_cache) {
+                grouped_summary = WorkflowSummary::createGrouped(task_summary);
+                if (not quiet) {
+                    fprintf(stderr, "GROUPED %lu TASKS INTO %lu GROUPS\n", grouped_summary.getNumTasks(), grouped_summary.work.size());
+                }
+            }
+            const WorkflowSummary &spec_summary = (group_tasks and not per_node_summary and not streaming) ? grouped_summary : task_summary;
+
+            // Search for the number of nodes, and use the Pareto front as core counts
+            std::vector<unsigned long> config_num_cores = num_cores;
+            if (deadline > 0) {
+                unsigned long max_num_nodes = max_num_cores > 0 ?
+                                              (max_num_cores + spec.num_cores_per_node - 1) / spec.num_cores_per_node :
+                                              std::max<unsigned long>(1, (summary.max_level_width + spec.num_cores_per_node - 1) / spec.num_cores_per_node);
+                EstimationWorkspace workspace(spec_summary);
+                auto estimate = [&](unsigned long n) -> double {
+                    struct platform_config config = base_config;
+                    config.num_nodes = n;
+                    if (per_node_summary) {
+                        auto cached = page_cache ?
+                                      WorkflowSummary::createWithPageCache(summary, n, config.page_cache_size_per_node) :
+                                      WorkflowSummary::createWithNetwork(summary, config);
+                        if (staging) {
+                            cached = WorkflowSummary::createWithStaging(cached, config);
+                        }
+                        return estimate_makespan_critical_path(group_tasks ? WorkflowSummary::createGrouped(cached) : cached, config);
+                    }
+                    return estimate_makespan_critical_path(spec_summary, config, workspace);
+                };
 
-            // Set task flops
-            for (auto const &t : workflow->getTasks()) {
-                t->setFlops(task_execution_time);
+                auto candidates = CoreCountSearch::getCandidateNumNodes(spec_summary, spec.num_cores_per_node, max_num_nodes);
+                unsigned long best = CoreCountSearch::findMinimalNumNodes(candidates, estimate, deadline);
+                if (best > 0) {
+                    candidates.insert(std::lower_bound(candidates.begin(), candidates.end(), best), best);
+                    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+                }
+
+                std::vector<double> makespans;
+                if (per_node_summary) {
+                    for (auto n : candidates) {
+                        makespans.push_back(estimate(n));
+                    }
+                } else {
+                    std::vector<struct platform_config> candidate_configs(candidates.size(), base_config);
+                    for (unsigned long i = 0; i < candidates.size(); i++) {
+                        candidate_configs[i].num_nodes = candidates[i];
+                    }
+                    makespans = estimate_makespan_critical_path_batch(spec_summary, candidate_configs, mc_spec.num_threads);
+                }
+                config_num_cores.clear();
+                for (auto i : CoreCountSearch::getParetoFront(candidates, makespans)) {
+                    config_num_cores.push_back(candidates[i] * spec.num_cores_per_node);
+                }
+
+                // With a core hour limit, the smallest number of nodes may be too slow for it, but not a larger one
+                while ((best > 0) and (max_core_hours > 0) and
+                       ((double)(best * spec.num_cores_per_node) * estimate(best) / 3600.0 > max_core_hours)) {
+                    auto next = std::upper_bound(config_num_cores.begin(), config_num_cores.end(), best * spec.num_cores_per_node);
+                    best = next == config_num_cores.end() ? 0 : *next / spec.num_cores_per_node;
+                }
+                if (best > 0) {
+                    fprintf(stderr, "PLATFORM %s: SMALLEST NUMBER OF CORES MEETING THE DEADLINE: %lu (%lu nodes, %.1lf seconds)\n",
+                            platform_spec.c_str(), best * spec.num_cores_per_node, best, estimate(best));
+                } else {
+                    fprintf(stderr, "PLATFORM %s: NO NUMBER OF CORES MEETS THE DEADLINE\n", platform_spec.c_str());
+                }
+            }
+            std::vector<struct platform_config> configs;
+            for (auto const &n : config_num_cores) {
+                configs.push_back(make_platform_config(spec, task_execution_time, n));
+                configs.back().parallel_fraction = parallel_fraction;
             }
 
-            auto total_data = compute_total_data(workflow);
-            double total_read_data = std::get<0>(total_data);
-            double total_written_data = std::get<1>(total_data);
-
-            unsigned long num_nodes = std::ceil((double)num_cores / (double)num_cores_per_node);
-
-            fprintf(stderr, "PLATFORM %s:\n", platform_spec.c_str());
-            fprintf(stderr, "  - %lu %lu-core nodes\n", num_nodes, num_cores_per_node);
-            fprintf(stderr, "  - task execution time: %.2lf sec\n", task_execution_time);
-            fprintf(stderr, "  - per-node I/O read rate: %.2lf MB/sec\n", io_read_speed_per_node / MBYTE);
-            fprintf(stderr, "  - per-node I/O write rate: %.2lf MB/sec\n", io_write_speed_per_node / MBYTE);
-            fprintf(stderr, "\nWORKFLOW:\n");
-            fprintf(stderr, "  - # TASKS:            %lu\n", workflow->getNumberOfTasks());
-            fprintf(stderr, "  - TASK TYPE:          %s\n", tt.first.c_str());
-            double total_work = compute_total_work(workflow);
-            fprintf(stderr, "  - TOTAL WORK:         %.2lf seconds (%.2lf hours)\n", total_work, total_work / 3600.0);
-            fprintf(stderr, "  - TOTAL DATA READ:    %.2lf GB\n", total_read_data / GBYTE);
-            fprintf(stderr, "  - TOTAL DATA WRITTEN: %.2lf GB\n", total_written_data / GBYTE);
-            double estimate1 = estimate_makespan_naive_no_overlap(workflow, num_nodes, num_cores_per_node,
-                                                                  io_read_speed_per_node, io_write_speed_per_node);
-            double estimate2 = estimate_makespan_naive_overlap(workflow, num_nodes, num_cores_per_node,
-                                                               io_read_speed_per_node, io_write_speed_per_node);
-            double estimate3 = estimate_makespan_critical_path(workflow, num_nodes, num_cores_per_node,
-                                                               io_read_speed_per_node, io_write_speed_per_node);
-            fprintf(stderr, "\nNAIVE / NO CONCURRENCY: %.1lf seconds\n", estimate1);
-            fprintf(stderr, "NAIVE / CONCURRENCY   : %.1lf seconds\n", estimate2);
-            fprintf(stderr, "CRITICAL PATH         : %.1lf seconds\n", estimate3);
-
-            // Code to print out CSV stuff
-            std::vector<std::string> tokens;
-            boost::split(tokens, workflow_file, boost::is_any_of("/"));
-            std::string after_slash = tokens.at(tokens.size() -1);
-            boost::split(tokens, after_slash, boost::is_any_of("-"));
-            fprintf(stdout, "\n\nCSV,%s,%s,%s,%s,%.2lf,%.2lf,%.2lf,%s,\n",
-                    tokens.at(0).c_str(),
-                    tokens.at(1).c_str(),
-                    tokens.at(2).c_str(),
-                    tt.first.c_str(),
-                    estimate1, estimate2, estimate3,
-                    platform_spec.c_str());
+            // Estimates for all core counts at once (with page caches or a network, bytes read depend on
+            // the number of nodes, and thus configurations are estimated one at a time)
+            std::vector<std::vector<double>> spec_estimates(estimators.size());
+            if (not per_node_summary and not from_cache) {
+                for (unsigned long e = 0; e < estimators.size(); e++) {
+                    if (streaming and (estimators[e]->getName() == "estimate3")) {
+                        // Level makespans are added up as levels are streamed back from disk
+                        spec_estimates[e].assign(configs.size(), 0.0);
+                        stream->forEachLevel([&](const WorkflowSummary &level_summary) {
+                            auto level_estimates = estimators[e]->estimateBatch(
+                                    group_tasks ? WorkflowSummary::createGrouped(level_summary) : level_summary,
+                                    configs, mc_spec.num_threads);
+                            for (unsigned long c = 0; c < configs.size(); c++) {
+                                spec_estimates[e][c] += level_estimates[c];
+                            }
+                        });
+                    } else {
+                        spec_estimates[e] = estimators[e]->estimateBatch(spec_summary, configs, mc_spec.num_threads);
+                    }
+                }
+            }
+
+            for (unsigned long c = 0; c < configs.size(); c++) {
+                auto const &config = configs[c];
+
+                WorkflowSummary cached_summary;
+                WorkflowSummary grouped_cached_summary;
+                if (per_node_summary and not from_cache) {
+                    cached_summary = page_cache ?
+                                     WorkflowSummary::createWithPageCache(summary, config.num_nodes, config.page_cache_size_per_node) :
+                                     WorkflowSummary::createWithNetwork(summary, config);
+                    if (staging) {
+                        cached_summary = WorkflowSummary::createWithStaging(cached_summary, config);
+                    }
+                    if (group_tasks) {
+                        grouped_cached_summary = WorkflowSummary::createGrouped(cached_summary);
+                    }
+                }
+                const WorkflowSummary &config_task_summary = per_node_summary ? cached_summary : task_summary;
+                WorkflowSummary cached_totals;
+                if (from_cache) {
+                    cached_totals.num_tasks = summary.num_tasks;
+                    cached_totals.total_work = summary.total_work;
+                }
+                const WorkflowSummary &config_summary = from_cache ? cached_totals :
+                                                        per_node_summary ? (group_tasks ? grouped_cached_summary : cached_summary) : spec_summary;
+
+                struct makespan_bounds bounds{};
+                std::vector<double> estimates(estimators.size());
+                if (from_cache) {
+                    cache->lookup(config_key(config, "total_bytes_read"), cached_totals.total_bytes_read);
+                    cache->lookup(config_key(config, "total_bytes_written"), cached_totals.total_bytes_written);
+                    cache->lookup(config_key(config, "lower_bound"), bounds.lower);
+                    cache->lookup(config_key(config, "upper_bound"), bounds.upper);
+                    for (unsigned long e = 0; e < estimators.size(); e++) {
+                        cache->lookup(estimator_key(config, *estimators[e]), estimates[e]);
+                    }
+                } else {
+                    if (not streaming) {
+                        bounds = compute_makespan_bounds(config_task_summary, config);
+                    }
+                    for (unsigned long e = 0; e < estimators.size(); e++) {
+                        estimates[e] = per_node_summary ? estimators[e]->estimateBatch(config_summary, {config}, mc_spec.num_threads)[0] :
+                                       spec_estimates[e][c];
+                    }
+                    if (cache) {
+                        cache->insert(config_key(config, "total_bytes_read"), config_summary.total_bytes_read);
+                        cache->insert(config_key(config, "total_bytes_written"), config_summary.total_bytes_written);
+                        if (not streaming) {
+                            cache->insert(config_key(config, "lower_bound"), bounds.lower);
+                            cache->insert(config_key(config, "upper_bound"), bounds.upper);
+                        }
+                        for (unsigned long e = 0; e < estimators.size(); e++) {
+                            cache->insert(estimator_key(config, *estimators[e]), estimates[e]);
+                        }
+                    }
+                }
+
+                std::array<struct estimate_percentiles, NUM_ESTIMATES> percentiles{};
+                if ((mc_spec.num_replicas > 0) and (not mc_estimates.empty())) {
+                    try {
+                        percentiles = MonteCarloEstimator::estimate(config_summary, config, mc_spec);
+                    } catch (std::invalid_argument &e) {
+                        std::cerr << "Error: " << e.what() << "\n";
+                        exit(1);
+                    }
+                }
+
+                if (not quiet) {
+                    fprintf(stderr, "PLATFORM %s:\n", platform_spec.c_str());
+                    fprintf(stderr, "  - %lu %lu-core nodes\n", config.num_nodes, config.num_cores_per_node);
+                    fprintf(stderr, "  - task execution time: %.2lf sec\n", task_execution_time);
+                    fprintf(stderr, "  - per-node I/O read rate: %.2lf MB/sec\n", config.io_read_speed_per_node / MBYTE);
+                    fprintf(stderr, "  - per-node I/O write rate: %.2lf MB/sec\n", config.io_write_speed_per_node / MBYTE);
+                    fprintf(stderr, "\nWORKFLOW:\n");
+                    fprintf(stderr, "  - # TASKS:            %lu\n", config_summary.getNumTasks());
+                    fprintf(stderr, "  - TASK TYPE:          %s\n", tt.first.c_str());
+                    double total_work = config_summary.total_work * task_execution_time;
+                    fprintf(stderr, "  - TOTAL WORK:         %.2lf seconds (%.2lf hours)\n", total_work, total_work / 3600.0);
+                    fprintf(stderr, "  - TOTAL DATA READ:    %.2lf GB\n", config_summary.total_bytes_read / GBYTE);
+                    fprintf(stderr, "  - TOTAL DATA WRITTEN: %.2lf GB\n", config_summary.total_bytes_written / GBYTE);
+                    fprintf(stderr, "\n");
+                    for (unsigned long e = 0; e < estimators.size(); e++) {
+                        fprintf(stderr, "%-22s: %.1lf seconds\n",
+                                boost::to_upper_copy(estimators[e]->getDescription()).c_str(), estimates[e]);
+                    }
+                    if (not streaming) {
+                        fprintf(stderr, "BOUNDS                : [%.1lf, %.1lf] seconds\n", bounds.lower, bounds.upper);
+                    }
+                    if ((mc_spec.num_replicas > 0) and (not mc_estimates.empty())) {
+                        fprintf(stderr, "\nMONTE CARLO (%lu replicas):\n", mc_spec.num_replicas);
+                        const char *names[NUM_ESTIMATES] = {"NAIVE / NO CONCURRENCY", "NAIVE / CONCURRENCY   ", "CRITICAL PATH         "};
+                        for (auto i : mc_estimates) {
+                            fprintf(stderr, "%s: p50 %.1lf  p90 %.1lf  p99 %.1lf seconds\n",
+                                    names[i], percentiles[i].p50, percentiles[i].p90, percentiles[i].p99);
+                        }
+                    }
+                    fprintf(stderr, "\n");
+                }
+
+                // Levels follow each other in the critical path estimate, which makes a timeline
+                if (profile_writer) {
+                    double start = 0.0;
+                    auto profiles = profile_makespan_critical_path(config_summary, config, mc_spec.num_threads);
+                    for (unsigned long l = 0; l < profiles.size(); l++) {
+                        auto const &p = profiles[l];
+                        double time = p.compute_time + p.io_time;
+                        profile_writer->addString(app);
+                        profile_writer->addString(platform_spec);
+                        profile_writer->addInteger((long)config_num_cores[c]);
+                        profile_writer->addInteger((long)l);
+                        profile_writer->addReal(start);
+                        profile_writer->addReal(p.makespan);
+                        profile_writer->addInteger((long)p.num_tasks);
+                        profile_writer->addInteger((long)p.num_batches);
+                        profile_writer->addReal(time > 0.0 ? p.compute_time / time : 0.0);
+                        profile_writer->addReal(time > 0.0 ? p.io_time / time : 0.0);
+                        profile_writer->addReal(p.core_utilization);
+                        profile_writer->addInteger((long)p.idle_cores);
+                        profile_writer->addReal(p.io_contention);
+                        profile_writer->endRow();
+                        start += p.makespan;
+                    }
+                }
+
+                writer->addString(app);
+                writer->addInteger(num_tasks_label);
+                writer->addInteger(data_size_label);
+                writer->addString(tt.first);
+                for (auto estimate : estimates) {
+                    writer->addReal(estimate);
+                }
+                writer->addString(platform_spec);
+                writer->addInteger((long)config_num_cores[c]);
+                if (not streaming) {
+                    writer->addReal(bounds.lower);
+                    writer->addReal(bounds.upper);
+                }
+                if (mc_spec.num_replicas > 0) {
+                    for (auto i : mc_estimates) {
+                        writer->addReal(percentiles[i].p50);
+                        writer->addReal(percentiles[i].p90);
+                        writer->addReal(percentiles[i].p99);
+                    }
+                }
+                writer->endRow();
+            }
         }
 
     }
 
+    writer->close();
+    if (profile_writer) {
+        profile_writer->close();
+    }
+
     return 0;
 }
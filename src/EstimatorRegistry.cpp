@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <dlfcn.h>
+#include <stdexcept>
+#include <EstimatorRegistry.h>
+#include <MakespanEstimators.h>
+#include <BatchEstimator.h>
+
+/**
+ * Documentation in .h file
+ */
+std::vector<double> MakespanEstimator::estimateBatch(const WorkflowSummary &summary,
+                                                     const std::vector<struct platform_config> &configs,
+                                                     unsigned long /* num_threads */) const {
+    std::vector<double> estimates;
+    estimates.reserve(configs.size());
+    for (auto const &config : configs) {
+        estimates.push_back(estimate(summary, config));
+    }
+    return estimates;
+}
+
+/**
+ * @brief The naive, no concurrency, estimator
+ */
+class NaiveNoOverlapEstimator : public MakespanEstimator {
+public:
+    std::string getName() const override { return "estimate1"; }
+    std::string getDescription() const override { return "Naive / no concurrency"; }
+    double estimate(const WorkflowSummary &summary, const struct platform_config &config) const override {
+        return estimate_makespan_naive_no_overlap(summary, config);
+    }
+};
+
+/**
+ * @brief The naive, concurrency, estimator
+ */
+class NaiveOverlapEstimator : public MakespanEstimator {
+public:
+    std::string getName() const override { return "estimate2"; }
+    std::string getDescription() const override { return "Naive / concurrency"; }
+    double estimate(const WorkflowSummary &summary, const struct platform_config &config) const override {
+        return estimate_makespan_naive_overlap(summary, config);
+    }
+};
+
+/**
+ * @brief The critical path estimator, which estimates several configurations at once with the batch kernel
+ */
+class CriticalPathEstimator : public MakespanEstimator {
+public:
+    std::string getName() const override { return "estimate3"; }
+    std::string getDescription() const override { return "Critical path"; }
+    std::string getVersion() const override { return "2"; }
+    double estimate(const WorkflowSummary &summary, const struct platform_config &config) const override {
+        return estimate_makespan_critical_path(summary, config);
+    }
+    std::vector<double> estimateBatch(const WorkflowSummary &summary,
+                                      const std::vector<struct platform_config> &configs,
+                                      unsigned long num_threads) const override {
+        // A single (valid) configuration is estimated directly, invalid ones being rejected by the batch estimator
+        if ((configs.size() == 1) and (configs[0].num_nodes * configs[0].num_cores_per_node > 0)) {
+            return {estimate_makespan_critical_path(summary, configs[0], num_threads)};
+        }
+        return estimate_makespan_critical_path_batch(summary, configs, num_threads);
+    }
+};
+
+/**
+ * @brief Get the registered estimators (the built-in estimators being registered on first use)
+ * @return the registered estimators
+ */
+std::vector<std::shared_ptr<MakespanEstimator>> &EstimatorRegistry::getRegistry() {
+    static std::vector<std::shared_ptr<MakespanEstimator>> registry = {
+            std::make_shared<NaiveNoOverlapEstimator>(),
+            std::make_shared<NaiveOverlapEstimator>(),
+            std::make_shared<CriticalPathEstimator>()};
+    return registry;
+}
+
+/**
+ * Documentation in .h file
+ */
+void EstimatorRegistry::registerEstimator(const std::shared_ptr<MakespanEstimator> &estimator) {
+    std::string name = estimator->getName();
+    if ((name.rfind("estimate", 0) != 0) or (name.find_first_of("_,") != std::string::npos)) {
+        throw std::invalid_argument("EstimatorRegistry::registerEstimator(): invalid estimator name '" + name +
+                                    "' (names must start with 'estimate' and have no '_' or ',')");
+    }
+    auto &registry = getRegistry();
+    for (auto const &e : registry) {
+        if (e->getName() == name) {
+            throw std::invalid_argument("EstimatorRegistry::registerEstimator(): estimator '" + name + "' is already registered");
+        }
+    }
+    registry.push_back(estimator);
+}
+
+/**
+ * Documentation in .h file
+ */
+void EstimatorRegistry::loadPlugin(const std::string &path) {
+    // Plug-in estimators must outlive the registry, so plug-ins are never unloaded
+    void *handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == nullptr) {
+        throw std::invalid_argument("EstimatorRegistry::loadPlugin(): cannot load plug-in " + path + ": " + dlerror());
+    }
+    auto register_function = (register_makespan_estimators_function)dlsym(handle, "register_makespan_estimators");
+    if (register_function == nullptr) {
+        throw std::invalid_argument("EstimatorRegistry::loadPlugin(): plug-in " + path +
+                                    " does not export register_makespan_estimators()");
+    }
+    register_function();
+}
+
+/**
+ * Documentation in .h file
+ */
+std::shared_ptr<MakespanEstimator> EstimatorRegistry::getEstimator(const std::string &name) {
+    for (auto const &e : getRegistry()) {
+        if (e->getName() == name) {
+            return e;
+        }
+    }
+    throw std::invalid_argument("EstimatorRegistry::getEstimator(): unknown estimator '" + name + "'");
+}
+
+/**
+ * Documentation in .h file
+ */
+std::vector<std::shared_ptr<MakespanEstimator>> EstimatorRegistry::getEstimators() {
+    return getRegistry();
+}
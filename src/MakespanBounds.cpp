@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include <MakespanBounds.h>
+#include <MakespanEstimators.h>
+
+/**
+ * Documentation in .h file
+ */
+struct makespan_bounds compute_makespan_bounds(const WorkflowSummary &summary,
+                                               const struct platform_config &config) {
+    if (summary.isGrouped()) {
+        throw std::invalid_argument("compute_makespan_bounds(): grouped summaries have no dependencies");
+    }
+
+    const unsigned long num_tasks = summary.work.size();
+    std::vector<double> lower_finish_times(num_tasks);
+    std::vector<double> upper_finish_times(num_tasks);
+    double lower_critical_path = 0.0;
+    double upper_critical_path = 0.0;
+    double lower_area = 0.0;
+    double upper_area = 0.0;
+    unsigned long max_task_cores = 1;
+    auto contention = [&config](unsigned long tasks_per_node) -> double {
+        return config.io_contention_exponent == 1.0 ? (double)tasks_per_node :
+               std::pow((double)tasks_per_node, config.io_contention_exponent);
+    };
+
+    for (unsigned long t = 0; t < num_tasks; t++) {
+        unsigned long cores = std::min<unsigned long>(summary.num_cores[t], config.num_cores_per_node);
+        double speedup = 1.0 / ((1.0 - config.parallel_fraction) + config.parallel_fraction / (double)cores);
+        double work = summary.work[t] / speedup;
+        double overlap = summary.hasOverlap() ? summary.overlap[t] : 0.0;
+        double lower_duration = compute_task_makespan(summary.bytes_read[t], summary.bytes_written[t], work, config, 1.0, overlap);
+        double upper_duration = compute_task_makespan(summary.bytes_read[t], summary.bytes_written[t], work, config,
+                                                      contention(config.num_cores_per_node - cores + 1), overlap);
+
+        // Tasks come after their parents, as they are in level order
+        double lower_start = 0.0;
+        double upper_start = 0.0;
+        for (unsigned long i = summary.parent_offsets[t]; i < summary.parent_offsets[t + 1]; i++) {
+            lower_start = std::max<double>(lower_start, lower_finish_times[summary.parents[i]]);
+            upper_start = std::max<double>(upper_start, upper_finish_times[summary.parents[i]]);
+        }
+        lower_finish_times[t] = lower_start + lower_duration;
+        upper_finish_times[t] = upper_start + upper_duration;
+        lower_critical_path = std::max<double>(lower_critical_path, lower_finish_times[t]);
+        upper_critical_path = std::max<double>(upper_critical_path, upper_finish_times[t]);
+
+        lower_area += work * config.task_execution_time * (double)cores;
+        upper_area += upper_duration * (double)cores;
+        max_task_cores = std::max<unsigned long>(max_task_cores, cores);
+    }
+
+    const double num_cores = (double)(config.num_nodes * config.num_cores_per_node);
+    // With a contention exponent below 1, the tasks of a node get more than its I/O bandwidths in total
+    const double io_scaling = config.io_contention_exponent < 1.0 ?
+                              (double)config.num_cores_per_node / contention(config.num_cores_per_node) : 1.0;
+    const double io_time = (summary.total_bytes_read / (config.io_read_speed_per_node * (double)config.num_nodes) +
+                            summary.total_bytes_written / (config.io_write_speed_per_node * (double)config.num_nodes)) / io_scaling;
+
+    struct makespan_bounds bounds{};
+    bounds.lower = std::max<double>(lower_critical_path, std::max<double>(lower_area / num_cores, io_time));
+    if (max_task_cores == 1) {
+        bounds.upper = upper_area / num_cores + (1.0 - 1.0 / num_cores) * upper_critical_path;
+    } else {
+        double num_busy_cores = (double)(config.num_nodes * (config.num_cores_per_node - max_task_cores + 1));
+        bounds.upper = upper_critical_path + upper_area / num_busy_cores;
+    }
+    return bounds;
+}
@@ -0,0 +1,613 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <MakespanEstimators.h>
+
+// Minimum number of tasks in a level for its tasks to be sorted in parallel
+#define PARALLEL_SORT_WIDTH (1UL << 16)
+
+/**
+ * @brief Sort indices by decreasing key, ties being broken by index. As this is a strict total order,
+ *        the result does not depend on the number of threads: chunks are sorted in parallel, and then
+ *        merged pairwise, in parallel.
+ *
+ * @param keys: the keys
+ * @param order: the indices to sort
+ * @param width: the number of indices
+ * @param num_threads: the number of threads
+ */
+static void sort_by_decreasing_keys(const double *keys, unsigned long *order, unsigned long width,
+                                    unsigned long num_threads) {
+    auto compare = [keys](unsigned long a, unsigned long b) -> bool {
+        return (keys[a] > keys[b]) or ((keys[a] == keys[b]) and (a < b));
+    };
+    if ((num_threads <= 1) or (width < PARALLEL_SORT_WIDTH)) {
+        std::sort(order, order + width, compare);
+        return;
+    }
+
+    std::vector<unsigned long> bounds;
+    for (unsigned long i = 0; i <= num_threads; i++) {
+        bounds.push_back(i * width / num_threads);
+    }
+    std::vector<std::thread> workers;
+    for (unsigned long i = 0; i < num_threads; i++) {
+        workers.emplace_back([&, i]() {
+            std::sort(order + bounds[i], order + bounds[i + 1], compare);
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    for (unsigned long step = 1; step < num_threads; step *= 2) {
+        workers.clear();
+        for (unsigned long i = 0; i + step < num_threads; i += 2 * step) {
+            unsigned long first = bounds[i];
+            unsigned long middle = bounds[i + step];
+            unsigned long last = bounds[std::min<unsigned long>(i + 2 * step, num_threads)];
+            workers.emplace_back([order, first, middle, last, &compare]() {
+                std::inplace_merge(order + first, order + middle, order + last, compare);
+            });
+        }
+        for (auto &w : workers) {
+            w.join();
+        }
+    }
+}
+
+/**
+ * @brief Constructor
+ * @param summary: the workflow summary for which the workspace will be used
+ */
+EstimationWorkspace::EstimationWorkspace(const WorkflowSummary &summary) :
+        keys(summary.max_level_width), order(summary.max_level_width),
+        io_times(summary.max_level_width), work_times(summary.max_level_width) {
+    if (summary.hasOverlap()) {
+        phase_tasks.reserve(summary.max_level_width);
+    }
+}
+
+/**
+ * @brief Add batches to a level profile
+ *
+ * @param profile: the level profile (nullptr if the level is not profiled)
+ * @param config: the platform configuration
+ * @param num_batches: the number of batches
+ * @param num_tasks: the number of tasks of each batch
+ * @param busy_cores: the number of cores running tasks in each batch
+ * @param compute_time: the sum over the batches of their average task compute time
+ * @param io_time: the sum over the batches of their average task I/O time (with contention)
+ * @param makespan: the sum over the batches of their makespan
+ */
+static void add_profile_batches(struct level_profile *profile,
+                                const struct platform_config &config,
+                                unsigned long num_batches,
+                                unsigned long num_tasks,
+                                unsigned long busy_cores,
+                                double compute_time,
+                                double io_time,
+                                double makespan) {
+    if (not profile) {
+        return;
+    }
+    profile->num_tasks += num_batches * num_tasks;
+    profile->num_batches += num_batches;
+    profile->compute_time += compute_time;
+    profile->io_time += io_time;
+    // Busy core-time, until it is divided by the allocation's core-time
+    profile->core_utilization += (double)busy_cores * makespan;
+    profile->idle_cores = config.num_nodes * config.num_cores_per_node - busy_cores;
+    profile->io_contention = std::max<double>(profile->io_contention, compute_io_contention(num_tasks, config));
+}
+
+double estimate_makespan_naive_no_overlap(const WorkflowSummary &summary,
+                                          const struct platform_config &config) {
+
+    double io_read_time = summary.total_bytes_read / (config.io_read_speed_per_node * (double)config.num_nodes);
+    double compute_time = summary.total_work * config.task_execution_time /
+                          ((double)config.num_nodes * (double)config.num_cores_per_node);
+    double io_write_time = summary.total_bytes_written / (config.io_write_speed_per_node * (double)config.num_nodes);
+
+    return io_read_time + compute_time + io_write_time;
+}
+
+double estimate_makespan_naive_overlap(const WorkflowSummary &summary,
+                                       const struct platform_config &config) {
+
+    double io_read_time = summary.total_bytes_read / (config.io_read_speed_per_node * (double)config.num_nodes);
+    double compute_time = summary.total_work * config.task_execution_time /
+                          ((double)config.num_nodes * (double)config.num_cores_per_node);
+    double io_write_time = summary.total_bytes_written / (config.io_write_speed_per_node * (double)config.num_nodes);
+
+    return std::max<double>(compute_time, io_read_time + io_write_time);
+}
+
+void sort_level_tasks(const WorkflowSummary &summary,
+                      unsigned long level,
+                      const struct platform_config &config,
+                      EstimationWorkspace &workspace,
+                      unsigned long num_threads) {
+
+    const unsigned long offset = summary.level_offsets[level];
+    const unsigned long width = summary.getLevelWidth(level);
+    const double *bytes_read = summary.bytes_read.data() + offset;
+    const double *bytes_written = summary.bytes_written.data() + offset;
+    const double *work = summary.work.data() + offset;
+    const double *overlap = summary.hasOverlap() ? summary.overlap.data() + offset : nullptr;
+    double *keys = workspace.keys.data();
+    unsigned long *order = workspace.order.data();
+
+    // Sort the tasks according to task makespans (ties broken by task order, so that the
+    // batches, and thus the estimate, are deterministic)
+    for (unsigned long t = 0; t < width; t++) {
+        keys[t] = compute_task_makespan(bytes_read[t], bytes_written[t], work[t], config, 1.0, overlap ? overlap[t] : 0.0);
+        order[t] = t;
+    }
+    sort_by_decreasing_keys(keys, order, width, num_threads);
+}
+
+/**
+ * @brief Estimate a level's makespan in a grouped summary. Batches are walked over groups of tasks rather
+ *        than tasks, and the full batches that lie within a single group are accounted for all at once,
+ *        so that the cost is linear in the number of groups.
+ *
+ * @param summary: the (grouped) workflow summary
+ * @param level: the level
+ * @param config: the platform configuration
+ * @param workspace: the workspace
+ * @param profile: the level profile to fill in (nullptr if the level is not profiled)
+ * @return a makespan in seconds
+ */
+static double estimate_makespan_level_grouped(const WorkflowSummary &summary,
+                                              unsigned long level,
+                                              const struct platform_config &config,
+                                              EstimationWorkspace &workspace,
+                                              struct level_profile *profile) {
+
+    const unsigned long offset = summary.level_offsets[level];
+    const unsigned long width = summary.getLevelWidth(level);
+    const double *bytes_read = summary.bytes_read.data() + offset;
+    const double *bytes_written = summary.bytes_written.data() + offset;
+    const double *work = summary.work.data() + offset;
+    const double *overlap = summary.hasOverlap() ? summary.overlap.data() + offset : nullptr;
+    const unsigned long *multiplicity = summary.multiplicity.data() + offset;
+    const unsigned long *order = workspace.order.data();
+
+    sort_level_tasks(summary, level, config, workspace);
+
+    unsigned long num_remaining_tasks = 0;
+    for (unsigned long i = 0; i < width; i++) {
+        num_remaining_tasks += multiplicity[i];
+    }
+
+    // Go through batches of tasks, group by group
+    const unsigned long batch_size = config.num_nodes * config.num_cores_per_node;
+    double level_makespan = 0.0;
+    unsigned long g = 0;
+    unsigned long num_group_tasks = width > 0 ? multiplicity[order[0]] : 0;
+    unsigned long num_batch_tasks = 0;
+    double sum_task_makespans = 0;
+    double sum_compute_times = 0;
+    double sum_io_times = 0;
+    while (num_remaining_tasks > 0) {
+        unsigned long t = order[g];
+        unsigned long num_tasks = std::min<unsigned long>(num_remaining_tasks, batch_size);
+        double io_contention = compute_io_contention(num_tasks, config);
+        double task_makespan = compute_task_makespan(bytes_read[t], bytes_written[t], work[t], config, io_contention,
+                                                     overlap ? overlap[t] : 0.0);
+        double compute_time = work[t] * config.task_execution_time;
+        double io_time = profile ? compute_task_makespan(bytes_read[t], bytes_written[t], 0.0, config, io_contention) : 0.0;
+
+        if ((num_batch_tasks == 0) and (num_group_tasks >= batch_size)) {
+            // Full batches of identical tasks
+            unsigned long num_batches = num_group_tasks / batch_size;
+            level_makespan += (double)num_batches * task_makespan;
+            add_profile_batches(profile, config, num_batches, batch_size, batch_size, (double)num_batches * compute_time,
+                                (double)num_batches * io_time, (double)num_batches * task_makespan);
+            num_group_tasks -= num_batches * batch_size;
+            num_remaining_tasks -= num_batches * batch_size;
+        } else {
+            unsigned long n = std::min<unsigned long>(num_group_tasks, num_tasks - num_batch_tasks);
+            sum_task_makespans += (double)n * task_makespan;
+            sum_compute_times += (double)n * compute_time;
+            sum_io_times += (double)n * io_time;
+            num_batch_tasks += n;
+            num_group_tasks -= n;
+            if (num_batch_tasks == num_tasks) {
+                level_makespan += sum_task_makespans / (double)num_tasks; // average task run time accounting for contention
+                add_profile_batches(profile, config, 1, num_tasks, num_tasks, sum_compute_times / (double)num_tasks,
+                                    sum_io_times / (double)num_tasks, sum_task_makespans / (double)num_tasks);
+                num_remaining_tasks -= num_tasks;
+                num_batch_tasks = 0;
+                sum_task_makespans = 0;
+                sum_compute_times = 0;
+                sum_io_times = 0;
+            }
+        }
+
+        if ((num_group_tasks == 0) and (++g < width)) {
+            num_group_tasks = multiplicity[order[g]];
+        }
+    }
+
+    return level_makespan;
+}
+
+/**
+ * @brief Estimate a level's makespan when some tasks need several cores. Tasks, sorted by decreasing
+ *        makespan (without contention), are packed into phases with a next-fit heuristic: a task goes on
+ *        the current node if it has enough idle cores, on the next node otherwise, and a new phase starts
+ *        when there is no next node. A task's compute time is divided by its speedup (Amdahl's law).
+ *
+ * @param summary: the workflow summary
+ * @param level: the level
+ * @param config: the platform configuration
+ * @param workspace: the workspace
+ * @param num_threads: the number of threads used to sort tasks
+ * @param profile: the level profile to fill in (nullptr if the level is not profiled)
+ * @return a makespan in seconds
+ */
+static double estimate_makespan_level_multicore(const WorkflowSummary &summary,
+                                                unsigned long level,
+                                                const struct platform_config &config,
+                                                EstimationWorkspace &workspace,
+                                                unsigned long num_threads,
+                                                struct level_profile *profile) {
+
+    const unsigned long offset = summary.level_offsets[level];
+    const unsigned long width = summary.getLevelWidth(level);
+    const double *bytes_read = summary.bytes_read.data() + offset;
+    const double *bytes_written = summary.bytes_written.data() + offset;
+    const unsigned long *num_cores = summary.num_cores.data() + offset;
+    const double *overlap = summary.hasOverlap() ? summary.overlap.data() + offset : nullptr;
+    double *keys = workspace.keys.data();
+    unsigned long *order = workspace.order.data();
+    double *io_times = workspace.io_times.data();
+    double *work_times = workspace.work_times.data();
+
+    // Sort the tasks according to task makespans (ties broken by task order)
+    for (unsigned long t = 0; t < width; t++) {
+        double cores = (double)std::min<unsigned long>(num_cores[t], config.num_cores_per_node);
+        double speedup = 1.0 / ((1.0 - config.parallel_fraction) + config.parallel_fraction / cores);
+        io_times[t] = bytes_read[t] / config.io_read_speed_per_node + bytes_written[t] / config.io_write_speed_per_node;
+        work_times[t] = summary.work[offset + t] * config.task_execution_time / speedup;
+        keys[t] = io_times[t] + work_times[t];
+        if (overlap) {
+            keys[t] -= overlap[t] * std::min<double>(io_times[t], work_times[t]);
+        }
+        order[t] = t;
+    }
+    sort_by_decreasing_keys(keys, order, width, num_threads);
+
+    // Pack tasks into phases
+    double level_makespan = 0.0;
+    unsigned long node = 0;
+    unsigned long idle_cores = config.num_cores_per_node;
+    unsigned long num_tasks = 0;
+    unsigned long busy_cores = 0;
+    double sum_io_times = 0.0;
+    double sum_work_times = 0.0;
+    // With overlap, task makespans are not linear in the contention, and are summed task by task at the
+    // end of the phase: (task, number of instances) of the phase
+    auto &phase_tasks = workspace.phase_tasks;
+    phase_tasks.clear();
+    auto end_phase = [&]() {
+        double io_contention = compute_io_contention(num_tasks, config);
+        double phase_makespan;
+        if (overlap) {
+            double sum_task_makespans = 0.0;
+            for (auto const &p : phase_tasks) {
+                double io_time = io_contention * io_times[p.first];
+                double work_time = work_times[p.first];
+                sum_task_makespans += (double)p.second *
+                                      (io_time + work_time - overlap[p.first] * std::min<double>(io_time, work_time));
+            }
+            phase_makespan = sum_task_makespans / (double)num_tasks;
+            phase_tasks.clear();
+        } else {
+            phase_makespan = (io_contention * sum_io_times + sum_work_times) / (double)num_tasks;
+        }
+        level_makespan += phase_makespan;
+        add_profile_batches(profile, config, 1, num_tasks, busy_cores, sum_work_times / (double)num_tasks,
+                            io_contention * sum_io_times / (double)num_tasks, phase_makespan);
+        node = 0;
+        idle_cores = config.num_cores_per_node;
+        num_tasks = 0;
+        busy_cores = 0;
+        sum_io_times = 0.0;
+        sum_work_times = 0.0;
+    };
+    for (unsigned long i = 0; i < width; i++) {
+        unsigned long t = order[i];
+        unsigned long cores = std::min<unsigned long>(num_cores[t], config.num_cores_per_node);
+        unsigned long multiplicity = summary.isGrouped() ? summary.multiplicity[offset + t] : 1;
+        for (unsigned long m = 0; m < multiplicity; m++) {
+            if (cores > idle_cores) {
+                idle_cores = config.num_cores_per_node;
+                if (++node == config.num_nodes) {
+                    end_phase();
+                }
+            }
+            idle_cores -= cores;
+            num_tasks++;
+            busy_cores += cores;
+            sum_io_times += io_times[t];
+            sum_work_times += work_times[t];
+            if (overlap) {
+                if ((not phase_tasks.empty()) and (phase_tasks.back().first == t)) {
+                    phase_tasks.back().second++;
+                } else {
+                    phase_tasks.emplace_back(t, 1);
+                }
+            }
+        }
+    }
+    if (num_tasks > 0) {
+        end_phase();
+    }
+
+    return level_makespan;
+}
+
+/**
+ * @brief Estimate a level's makespan once its last, partial, batch is known. All full batches have the same
+ *        number of tasks, and thus the same contention, so that the sum of their average task makespans is
+ *        the sum of their task makespans divided by the batch size. Task makespans are summed in task order
+ *        (rather than in batch order), so that the estimate only depends on which tasks are in the last
+ *        batch, and not on whether they were found by a sort or a selection.
+ *
+ * @param summary: the workflow summary
+ * @param level: the level
+ * @param config: the platform configuration
+ * @param keys: the per-task keys, those of the tasks of the last batch being negative (only read if the
+ *              level has both full batches and a partial batch)
+ * @param profile: the level profile to fill in (nullptr if the level is not profiled)
+ * @return a makespan in seconds
+ */
+static double estimate_makespan_level_batches(const WorkflowSummary &summary,
+                                              unsigned long level,
+                                              const struct platform_config &config,
+                                              const double *keys,
+                                              struct level_profile *profile) {
+
+    const unsigned long offset = summary.level_offsets[level];
+    const unsigned long width = summary.getLevelWidth(level);
+    const double *bytes_read = summary.bytes_read.data() + offset;
+    const double *bytes_written = summary.bytes_written.data() + offset;
+    const double *work = summary.work.data() + offset;
+    const double *overlap = summary.hasOverlap() ? summary.overlap.data() + offset : nullptr;
+
+    const unsigned long batch_size = config.num_nodes * config.num_cores_per_node;
+    const unsigned long last_batch_size = width % batch_size;
+    const unsigned long last_batch_start = width - last_batch_size;
+    const bool flagged = (last_batch_size > 0) and (last_batch_start > 0);
+    const double io_contentions[2] = {compute_io_contention(batch_size, config),
+                                      compute_io_contention(last_batch_size, config)};
+
+    // Sums over the tasks of the full batches [0] and of the last batch [1]
+    double sum_task_makespans[2] = {0, 0};
+    double sum_compute_times[2] = {0, 0};
+    double sum_io_times[2] = {0, 0};
+    for (unsigned long t = 0; t < width; t++) {
+        int b = flagged ? (keys[t] < 0.0) : (last_batch_start == 0);
+        sum_task_makespans[b] += compute_task_makespan(bytes_read[t], bytes_written[t], work[t],
+                                                       config, io_contentions[b], overlap ? overlap[t] : 0.0);
+        if (profile) {
+            sum_compute_times[b] += work[t] * config.task_execution_time;
+            sum_io_times[b] += compute_task_makespan(bytes_read[t], bytes_written[t], 0.0, config, io_contentions[b]);
+        }
+    }
+
+    // Average task run times accounting for contention
+    double level_makespan = 0.0;
+    if (last_batch_start > 0) {
+        level_makespan += sum_task_makespans[0] / (double)batch_size;
+        add_profile_batches(profile, config, last_batch_start / batch_size, batch_size, batch_size,
+                            sum_compute_times[0] / (double)batch_size, sum_io_times[0] / (double)batch_size,
+                            sum_task_makespans[0] / (double)batch_size);
+    }
+    if (last_batch_size > 0) {
+        level_makespan += sum_task_makespans[1] / (double)last_batch_size;
+        add_profile_batches(profile, config, 1, last_batch_size, last_batch_size,
+                            sum_compute_times[1] / (double)last_batch_size, sum_io_times[1] / (double)last_batch_size,
+                            sum_task_makespans[1] / (double)last_batch_size);
+    }
+
+    return level_makespan;
+}
+
+double estimate_makespan_level_sorted(const WorkflowSummary &summary,
+                                      unsigned long level,
+                                      const struct platform_config &config,
+                                      EstimationWorkspace &workspace,
+                                      unsigned long num_threads) {
+
+    const unsigned long width = summary.getLevelWidth(level);
+    double *keys = workspace.keys.data();
+    const unsigned long *order = workspace.order.data();
+
+    sort_level_tasks(summary, level, config, workspace, num_threads);
+
+    // Flag the tasks of the last batch, i.e., the shortest ones (task makespans are not negative)
+    const unsigned long batch_size = config.num_nodes * config.num_cores_per_node;
+    for (unsigned long i = width - width % batch_size; i < width; i++) {
+        keys[order[i]] = -1.0;
+    }
+
+    return estimate_makespan_level_batches(summary, level, config, keys, nullptr);
+}
+
+/**
+ * @brief Estimate a level's makespan (see estimate_makespan_level()), and optionally profile it
+ *
+ * @param summary: the workflow summary
+ * @param level: the level
+ * @param config: the platform configuration
+ * @param workspace: the workspace
+ * @param num_threads: the number of threads used to sort (multi-core tasks only)
+ * @param profile: the level profile to fill in (nullptr if the level is not profiled)
+ * @return a makespan in seconds
+ */
+static double estimate_makespan_level(const WorkflowSummary &summary,
+                                      unsigned long level,
+                                      const struct platform_config &config,
+                                      EstimationWorkspace &workspace,
+                                      unsigned long num_threads,
+                                      struct level_profile *profile) {
+
+    if (summary.hasMultiCoreTasks()) {
+        return estimate_makespan_level_multicore(summary, level, config, workspace, num_threads, profile);
+    }
+    if (summary.isGrouped()) {
+        return estimate_makespan_level_grouped(summary, level, config, workspace, profile);
+    }
+
+    const unsigned long offset = summary.level_offsets[level];
+    const unsigned long width = summary.getLevelWidth(level);
+    const double *bytes_read = summary.bytes_read.data() + offset;
+    const double *bytes_written = summary.bytes_written.data() + offset;
+    const double *work = summary.work.data() + offset;
+    const double *overlap = summary.hasOverlap() ? summary.overlap.data() + offset : nullptr;
+    double *keys = workspace.keys.data();
+    unsigned long *order = workspace.order.data();
+
+    // Only the tasks of the last (partial) batch need to be known (see estimate_makespan_level_batches()):
+    // they are the shortest ones, and are selected in linear time (with the same order as
+    // sort_level_tasks(), so that batches are those of the sort)
+    const unsigned long batch_size = config.num_nodes * config.num_cores_per_node;
+    const unsigned long last_batch_size = width % batch_size;
+    const unsigned long last_batch_start = width - last_batch_size;
+    if ((last_batch_size > 0) and (last_batch_start > 0)) {
+        for (unsigned long t = 0; t < width; t++) {
+            keys[t] = compute_task_makespan(bytes_read[t], bytes_written[t], work[t], config, 1.0, overlap ? overlap[t] : 0.0);
+            order[t] = t;
+        }
+        std::nth_element(order, order + last_batch_start, order + width, [keys](unsigned long a, unsigned long b) -> bool {
+            return (keys[a] > keys[b]) or ((keys[a] == keys[b]) and (a < b));
+        });
+        for (unsigned long i = last_batch_start; i < width; i++) {
+            keys[order[i]] = -1.0;
+        }
+    }
+
+    return estimate_makespan_level_batches(summary, level, config, keys, profile);
+}
+
+double estimate_makespan_level(const WorkflowSummary &summary,
+                               unsigned long level,
+                               const struct platform_config &config,
+                               EstimationWorkspace &workspace,
+                               unsigned long num_threads) {
+    return estimate_makespan_level(summary, level, config, workspace, num_threads, nullptr);
+}
+
+struct level_profile profile_makespan_level(const WorkflowSummary &summary,
+                                            unsigned long level,
+                                            const struct platform_config &config,
+                                            EstimationWorkspace &workspace) {
+    struct level_profile profile{};
+    profile.makespan = estimate_makespan_level(summary, level, config, workspace, 1, &profile);
+    double core_time = (double)(config.num_nodes * config.num_cores_per_node) * profile.makespan;
+    profile.core_utilization = core_time > 0.0 ? profile.core_utilization / core_time : 0.0;
+    return profile;
+}
+
+double estimate_makespan_critical_path(const WorkflowSummary &summary,
+                                       const struct platform_config &config,
+                                       EstimationWorkspace &workspace) {
+
+    double makespan = 0.0;
+    for (unsigned long i = 0; i < summary.getNumLevels(); i++) {
+        makespan += estimate_makespan_level(summary, i, config, workspace);
+    }
+    return makespan;
+}
+
+double estimate_makespan_critical_path(const WorkflowSummary &summary,
+                                       const struct platform_config &config) {
+    EstimationWorkspace workspace(summary);
+    return estimate_makespan_critical_path(summary, config, workspace);
+}
+
+double estimate_makespan_critical_path(const WorkflowSummary &summary,
+                                       const struct platform_config &config,
+                                       unsigned long num_threads) {
+
+    const unsigned long num_levels = summary.getNumLevels();
+    if ((num_threads <= 1) or (num_levels == 0)) {
+        return estimate_makespan_critical_path(summary, config);
+    }
+
+    // With multi-core tasks, wide levels are estimated one at a time, with a parallel sort (without them,
+    // levels only select the tasks of their last batch, and are all estimated concurrently)
+    std::vector<double> level_makespans(num_levels, 0.0);
+    std::vector<unsigned long> narrow_levels;
+    {
+        EstimationWorkspace workspace(summary);
+        for (unsigned long i = 0; i < num_levels; i++) {
+            if (summary.hasMultiCoreTasks() and (summary.getLevelWidth(i) >= PARALLEL_SORT_WIDTH)) {
+                level_makespans[i] = estimate_makespan_level(summary, i, config, workspace, num_threads);
+            } else {
+                narrow_levels.push_back(i);
+            }
+        }
+    }
+
+    // Other levels are estimated concurrently, each thread taking the next level to estimate
+    std::atomic<unsigned long> next(0);
+    std::vector<std::thread> workers;
+    for (unsigned long t = 0; t < std::min<unsigned long>(num_threads, narrow_levels.size()); t++) {
+        workers.emplace_back([&summary, &config, &narrow_levels, &level_makespans, &next]() {
+            EstimationWorkspace workspace(summary);
+            for (unsigned long i = next++; i < narrow_levels.size(); i = next++) {
+                level_makespans[narrow_levels[i]] = estimate_makespan_level(summary, narrow_levels[i], config, workspace);
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+
+    // Sum in level order, as estimate_makespan_critical_path() does
+    double makespan = 0.0;
+    for (unsigned long i = 0; i < num_levels; i++) {
+        makespan += level_makespans[i];
+    }
+    return makespan;
+}
+
+std::vector<struct level_profile> profile_makespan_critical_path(const WorkflowSummary &summary,
+                                                                 const struct platform_config &config,
+                                                                 unsigned long num_threads) {
+
+    const unsigned long num_levels = summary.getNumLevels();
+    std::vector<struct level_profile> profiles(num_levels);
+
+    // Each thread takes the next level to profile
+    std::atomic<unsigned long> next(0);
+    auto profile = [&summary, &config, &profiles, &next, num_levels]() {
+        EstimationWorkspace workspace(summary);
+        for (unsigned long i = next++; i < num_levels; i = next++) {
+            profiles[i] = profile_makespan_level(summary, i, config, workspace);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned long t = 1; t < std::min<unsigned long>(num_threads, num_levels); t++) {
+        workers.emplace_back(profile);
+    }
+    profile();
+    for (auto &w : workers) {
+        w.join();
+    }
+    return profiles;
+}
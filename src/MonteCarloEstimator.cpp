@@ -0,0 +1,163 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <MakespanEstimators.h>
+#include <MonteCarloEstimator.h>
+
+// Number of replicas whose parameters are sampled (from the block's own random number stream), and whose
+// naive estimates are computed, together
+#define REPLICA_BLOCK 64
+
+/**
+ * @brief Create a log-normal distribution with a given mean and coefficient of variation
+ * @param mean: the mean
+ * @param cv: the coefficient of variation
+ * @return a distribution
+ */
+static std::lognormal_distribution<double> make_distribution(double mean, double cv) {
+    double sigma2 = std::log(1.0 + cv * cv);
+    return std::lognormal_distribution<double>(std::log(mean) - sigma2 / 2.0, std::sqrt(sigma2));
+}
+
+/**
+ * Documentation in .h file
+ */
+std::array<struct estimate_percentiles, NUM_ESTIMATES> MonteCarloEstimator::estimate(const WorkflowSummary &summary,
+                                                                                     const struct platform_config &config,
+                                                                                     const struct monte_carlo_spec &spec) {
+    if (spec.num_replicas == 0) {
+        throw std::invalid_argument("MonteCarloEstimator::estimate(): the number of replicas should be > 0");
+    }
+    if ((spec.cv_task_execution_time < 0) or (spec.cv_io_read_speed < 0) or (spec.cv_io_write_speed < 0)) {
+        throw std::invalid_argument("MonteCarloEstimator::estimate(): coefficients of variation should be >= 0");
+    }
+
+    std::array<std::vector<double>, NUM_ESTIMATES> results;
+    for (auto &r : results) {
+        r.resize(spec.num_replicas);
+    }
+
+    // Each thread runs a contiguous range of blocks of replicas. As each block has its own random number
+    // stream, results do not depend on the number of threads.
+    unsigned long num_blocks = (spec.num_replicas + REPLICA_BLOCK - 1) / REPLICA_BLOCK;
+    unsigned long num_threads = std::max<unsigned long>(1, std::min<unsigned long>(spec.num_threads, num_blocks));
+    std::vector<std::thread> workers;
+    for (unsigned long i = 0; i < num_threads; i++) {
+        unsigned long first_block = i * num_blocks / num_threads;
+        unsigned long last_block = (i + 1) * num_blocks / num_threads;
+        workers.emplace_back([&summary, &config, &spec, &results, first_block, last_block]() {
+            runReplicas(summary, config, spec, first_block, last_block, results);
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+
+    std::array<struct estimate_percentiles, NUM_ESTIMATES> percentiles{};
+    for (int i = 0; i < NUM_ESTIMATES; i++) {
+        percentiles[i] = computePercentiles(results[i]);
+    }
+    return percentiles;
+}
+
+/**
+ * @brief Run a range of blocks of replicas
+ *
+ * @param summary: the workflow summary
+ * @param config: the (nominal) platform configuration
+ * @param spec: the Monte Carlo parameters
+ * @param first_block: the first block (included)
+ * @param last_block: the last block (excluded)
+ * @param results: the per-estimate vectors of replica results to fill in
+ */
+void MonteCarloEstimator::runReplicas(const WorkflowSummary &summary,
+                                      const struct platform_config &config,
+                                      const struct monte_carlo_spec &spec,
+                                      unsigned long first_block,
+                                      unsigned long last_block,
+                                      std::array<std::vector<double>, NUM_ESTIMATES> &results) {
+
+    std::mt19937_64 rng;
+    auto task_execution_time_dist = make_distribution(config.task_execution_time, spec.cv_task_execution_time);
+    auto io_read_speed_dist = make_distribution(config.io_read_speed_per_node, spec.cv_io_read_speed);
+    auto io_write_speed_dist = make_distribution(config.io_write_speed_per_node, spec.cv_io_write_speed);
+
+    // All memory is allocated up front, so the replica loop is allocation-free
+    EstimationWorkspace workspace(summary);
+    double task_execution_times[REPLICA_BLOCK];
+    double io_read_speeds[REPLICA_BLOCK];
+    double io_write_speeds[REPLICA_BLOCK];
+
+    const double num_nodes = (double)config.num_nodes;
+    const double num_cores = (double)config.num_nodes * (double)config.num_cores_per_node;
+
+    for (unsigned long b = first_block; b < last_block; b++) {
+        unsigned long block = b * REPLICA_BLOCK;
+        unsigned long n = std::min<unsigned long>(REPLICA_BLOCK, spec.num_replicas - block);
+
+        // The block's random number stream is seeded by the seed and the block index (distributions
+        // being reset, as they may hold values drawn from the previous block's stream)
+        std::seed_seq seed{(unsigned long)spec.seed, b};
+        rng.seed(seed);
+        task_execution_time_dist.reset();
+        io_read_speed_dist.reset();
+        io_write_speed_dist.reset();
+
+        for (unsigned long k = 0; k < n; k++) {
+            task_execution_times[k] = spec.cv_task_execution_time > 0 ? task_execution_time_dist(rng) : config.task_execution_time;
+            io_read_speeds[k] = spec.cv_io_read_speed > 0 ? io_read_speed_dist(rng) : config.io_read_speed_per_node;
+            io_write_speeds[k] = spec.cv_io_write_speed > 0 ? io_write_speed_dist(rng) : config.io_write_speed_per_node;
+        }
+
+        // Naive estimates, computed over the whole block of replicas at once
+        double *estimate1 = results[0].data() + block;
+        double *estimate2 = results[1].data() + block;
+        for (unsigned long k = 0; k < n; k++) {
+            double io_read_time = summary.total_bytes_read / (io_read_speeds[k] * num_nodes);
+            double compute_time = summary.total_work * task_execution_times[k] / num_cores;
+            double io_write_time = summary.total_bytes_written / (io_write_speeds[k] * num_nodes);
+            estimate1[k] = io_read_time + compute_time + io_write_time;
+            estimate2[k] = std::max<double>(compute_time, io_read_time + io_write_time);
+        }
+
+        // Critical path estimates, which reuse the workspace
+        double *estimate3 = results[2].data() + block;
+        struct platform_config replica_config = config;
+        for (unsigned long k = 0; k < n; k++) {
+            replica_config.task_execution_time = task_execution_times[k];
+            replica_config.io_read_speed_per_node = io_read_speeds[k];
+            replica_config.io_write_speed_per_node = io_write_speeds[k];
+            estimate3[k] = estimate_makespan_critical_path(summary, replica_config, workspace);
+        }
+    }
+}
+
+/**
+ * @brief Compute (nearest-rank) percentiles of a set of values
+ * @param values: the values (which are re-ordered)
+ * @return the percentiles
+ */
+struct estimate_percentiles MonteCarloEstimator::computePercentiles(std::vector<double> &values) {
+    auto percentile = [&values](double p) -> double {
+        auto rank = (unsigned long)std::ceil(p * (double)values.size());
+        auto nth = values.begin() + (long)(std::max<unsigned long>(rank, 1) - 1);
+        std::nth_element(values.begin(), nth, values.end());
+        return *nth;
+    };
+    struct estimate_percentiles percentiles{};
+    percentiles.p50 = percentile(0.50);
+    percentiles.p90 = percentile(0.90);
+    percentiles.p99 = percentile(0.99);
+    return percentiles;
+}
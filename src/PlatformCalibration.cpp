@@ -0,0 +1,405 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <PlatformCalibration.h>
+
+/** @brief Step of the forward differences (on the logarithms of the time and bandwidths, and on the exponent) */
+#define CALIBRATION_DIFFERENCE_STEP 1.0e-3
+/** @brief Largest factor between a fitted and an initial time or bandwidth */
+#define CALIBRATION_MAX_FACTOR 1.0e4
+/** @brief Range of the fitted I/O contention exponent */
+#define CALIBRATION_MAX_EXPONENT 2.0
+/** @brief Levenberg-Marquardt damping range, and relative cost decrease under which a fit has converged */
+#define CALIBRATION_MIN_DAMPING 1.0e-9
+#define CALIBRATION_MAX_DAMPING 1.0e9
+#define CALIBRATION_TOLERANCE 1.0e-9
+
+/**
+ * @brief Get a table cell as a string (numbers are formatted as integers, as they are labels)
+ */
+static std::string cell_string(const struct result_table &table, long column, unsigned long row) {
+    if (table.schema[column].type == column_type::STRING) {
+        return table.strings[column][row];
+    }
+    return std::to_string((long)table.numbers[column][row]);
+}
+
+/**
+ * @brief Get the index of a required column
+ */
+static long required_column(const struct result_table &table, const std::string &name) {
+    long index = table.getColumnIndex(name);
+    if (index < 0) {
+        throw std::invalid_argument("PlatformCalibration::getObservations(): missing column " + name);
+    }
+    return index;
+}
+
+/**
+ * @brief Get the calibrated parameters of a configuration: the logarithms of the task execution time and of
+ *        the per-node read and write bandwidths, and the I/O contention exponent
+ *
+ * @param config: the platform configuration
+ * @param parameters: the parameters (output)
+ */
+static void get_parameters(const struct platform_config &config, double *parameters) {
+    parameters[0] = std::log(config.task_execution_time);
+    parameters[1] = std::log(config.io_read_speed_per_node);
+    parameters[2] = std::log(config.io_write_speed_per_node);
+    parameters[3] = config.io_contention_exponent;
+}
+
+/**
+ * @brief Bring parameters back within the calibration range
+ *
+ * @param parameters: the parameters
+ * @param initial_parameters: the initial parameters
+ */
+static void clamp_parameters(double *parameters, const double *initial_parameters) {
+    const double max_log_factor = std::log(CALIBRATION_MAX_FACTOR);
+    for (int p = 0; p < 3; p++) {
+        parameters[p] = std::min<double>(std::max<double>(parameters[p], initial_parameters[p] - max_log_factor),
+                                         initial_parameters[p] + max_log_factor);
+    }
+    parameters[3] = std::min<double>(std::max<double>(parameters[3], 0.0), CALIBRATION_MAX_EXPONENT);
+}
+
+/**
+ * @brief Solve a (damped normal equations) linear system by Gaussian elimination with partial pivoting
+ *
+ * @param a: the matrix, which is overwritten
+ * @param b: the right-hand side, which is overwritten with the solution
+ * @return false if the matrix is singular
+ */
+static bool solve_linear_system(double a[NUM_CALIBRATION_PARAMETERS][NUM_CALIBRATION_PARAMETERS],
+                                double b[NUM_CALIBRATION_PARAMETERS]) {
+    for (int c = 0; c < NUM_CALIBRATION_PARAMETERS; c++) {
+        int pivot = c;
+        for (int r = c + 1; r < NUM_CALIBRATION_PARAMETERS; r++) {
+            if (std::fabs(a[r][c]) > std::fabs(a[pivot][c])) {
+                pivot = r;
+            }
+        }
+        if (a[pivot][c] == 0.0) {
+            return false;
+        }
+        std::swap(a[c], a[pivot]);
+        std::swap(b[c], b[pivot]);
+        for (int r = c + 1; r < NUM_CALIBRATION_PARAMETERS; r++) {
+            double factor = a[r][c] / a[c][c];
+            for (int k = c; k < NUM_CALIBRATION_PARAMETERS; k++) {
+                a[r][k] -= factor * a[c][k];
+            }
+            b[r] -= factor * b[c];
+        }
+    }
+    for (int c = NUM_CALIBRATION_PARAMETERS - 1; c >= 0; c--) {
+        for (int k = c + 1; k < NUM_CALIBRATION_PARAMETERS; k++) {
+            b[c] -= a[c][k] * b[k];
+        }
+        b[c] /= a[c][c];
+    }
+    return true;
+}
+
+/**
+ * Documentation in .h file
+ */
+std::vector<struct calibration_observation> PlatformCalibration::getObservations(const struct result_table &real,
+                                                                                 const std::string &machine,
+                                                                                 const std::string &type,
+                                                                                 const std::vector<std::tuple<std::string, long, long>> &labels,
+                                                                                 unsigned long num_cores) {
+    long app_column = required_column(real, "app");
+    long num_tasks_column = required_column(real, "num_tasks");
+    long data_size_column = required_column(real, "data_size");
+    long type_column = required_column(real, "type");
+    long makespan_column = required_column(real, "makespan");
+    long machine_column = required_column(real, "machine");
+    long num_cores_column = real.getColumnIndex("num_cores");
+    if (real.schema[makespan_column].type == column_type::STRING) {
+        throw std::invalid_argument("PlatformCalibration::getObservations(): non-numeric makespan column");
+    }
+    if ((num_cores_column >= 0) and (real.schema[num_cores_column].type == column_type::STRING)) {
+        throw std::invalid_argument("PlatformCalibration::getObservations(): non-numeric num_cores column");
+    }
+
+    // Index workflows by labels, keeping the first one of each
+    std::unordered_map<std::string, unsigned long> workflows;
+    for (unsigned long w = 0; w < labels.size(); w++) {
+        workflows.emplace(std::get<0>(labels[w]) + '\x1f' + std::to_string(std::get<1>(labels[w])) + '\x1f' +
+                          std::to_string(std::get<2>(labels[w])), w);
+    }
+
+    std::vector<struct calibration_observation> observations;
+    for (unsigned long r = 0; r < real.num_rows; r++) {
+        double makespan = real.numbers[makespan_column][r];
+        if ((cell_string(real, machine_column, r) != machine) or (cell_string(real, type_column, r) != type) or
+            std::isnan(makespan) or (makespan <= 0.0)) {
+            continue;
+        }
+        auto it = workflows.find(cell_string(real, app_column, r) + '\x1f' + cell_string(real, num_tasks_column, r) +
+                                 '\x1f' + cell_string(real, data_size_column, r));
+        if (it == workflows.end()) {
+            continue;
+        }
+        struct calibration_observation observation{it->second, num_cores, makespan};
+        if ((num_cores_column >= 0) and (not std::isnan(real.numbers[num_cores_column][r]))) {
+            observation.num_cores = (unsigned long)real.numbers[num_cores_column][r];
+        }
+        if (observation.num_cores == 0) {
+            throw std::invalid_argument("PlatformCalibration::getObservations(): unknown number of cores for row " +
+                                        std::to_string(r + 1));
+        }
+        observations.push_back(observation);
+    }
+    return observations;
+}
+
+/**
+ * Documentation in .h file
+ */
+std::vector<double> PlatformCalibration::computeRelativeErrors(const std::vector<WorkflowSummary> &summaries,
+                                                               const std::vector<struct calibration_observation> &observations,
+                                                               const MakespanEstimator &estimator,
+                                                               const struct platform_config &config) {
+    std::vector<double> errors(observations.size());
+    struct platform_config observation_config = config;
+    for (unsigned long i = 0; i < observations.size(); i++) {
+        auto const &o = observations[i];
+        observation_config.num_nodes = (o.num_cores + config.num_cores_per_node - 1) / config.num_cores_per_node;
+        errors[i] = (estimator.estimate(summaries[o.workflow], observation_config) - o.makespan) / o.makespan;
+    }
+    return errors;
+}
+
+/**
+ * Documentation in .h file
+ */
+struct calibration_result PlatformCalibration::calibrate(const std::vector<WorkflowSummary> &summaries,
+                                                         const std::vector<struct calibration_observation> &observations,
+                                                         const MakespanEstimator &estimator,
+                                                         const struct platform_config &initial_config,
+                                                         const struct calibration_spec &spec) {
+    if (observations.empty()) {
+        throw std::invalid_argument("PlatformCalibration::calibrate(): no observations");
+    }
+    if (spec.num_starts == 0) {
+        throw std::invalid_argument("PlatformCalibration::calibrate(): there must be at least one starting point");
+    }
+    if (spec.spread < 1.0) {
+        throw std::invalid_argument("PlatformCalibration::calibrate(): the spread must be at least 1");
+    }
+    if ((initial_config.task_execution_time <= 0.0) or (initial_config.io_read_speed_per_node <= 0.0) or
+        (initial_config.io_write_speed_per_node <= 0.0)) {
+        throw std::invalid_argument("PlatformCalibration::calibrate(): the initial task execution time and bandwidths must be positive");
+    }
+    for (auto const &o : observations) {
+        if (o.workflow >= summaries.size()) {
+            throw std::invalid_argument("PlatformCalibration::calibrate(): invalid workflow index");
+        }
+    }
+
+    // Starting points: the initial parameters, and random points around them (each drawn from its own
+    // random number stream, so that they do not depend on the number of threads)
+    double initial_parameters[NUM_CALIBRATION_PARAMETERS];
+    get_parameters(initial_config, initial_parameters);
+    clamp_parameters(initial_parameters, initial_parameters);
+    std::vector<std::array<double, NUM_CALIBRATION_PARAMETERS>> starts(spec.num_starts);
+    std::copy(initial_parameters, initial_parameters + NUM_CALIBRATION_PARAMETERS, starts[0].begin());
+    std::uniform_real_distribution<double> log_factor(-std::log(spec.spread), std::log(spec.spread));
+    std::uniform_real_distribution<double> exponent(0.5, 1.5);
+    for (unsigned long s = 1; s < spec.num_starts; s++) {
+        std::seed_seq seed{(unsigned long)spec.seed, s};
+        std::mt19937_64 rng(seed);
+        for (int p = 0; p < 3; p++) {
+            starts[s][p] = initial_parameters[p] + log_factor(rng);
+        }
+        starts[s][3] = exponent(rng);
+        clamp_parameters(starts[s].data(), initial_parameters);
+    }
+
+    // Each thread fits the next starting point
+    std::vector<double> costs(spec.num_starts);
+    std::vector<unsigned long> num_evaluations(spec.num_starts, 0);
+    std::atomic<unsigned long> next(0);
+    auto fit = [&]() {
+        for (unsigned long s = next++; s < spec.num_starts; s = next++) {
+            costs[s] = fitParameters(summaries, observations, estimator, initial_config, spec.max_iterations,
+                                     starts[s].data(), num_evaluations[s]);
+        }
+    };
+    unsigned long num_threads = std::max<unsigned long>(1, std::min<unsigned long>(spec.num_threads, spec.num_starts));
+    std::vector<std::thread> workers;
+    for (unsigned long t = 1; t < num_threads; t++) {
+        workers.emplace_back(fit);
+    }
+    fit();
+    for (auto &w : workers) {
+        w.join();
+    }
+
+    struct calibration_result result{};
+    for (unsigned long s = 0; s < spec.num_starts; s++) {
+        if (costs[s] < costs[result.best_start]) {
+            result.best_start = s;
+        }
+        result.num_evaluations += num_evaluations[s];
+    }
+    result.config = initial_config;
+    setParameters(starts[result.best_start].data(), result.config);
+
+    auto initial_errors = computeRelativeErrors(summaries, observations, estimator, initial_config);
+    auto errors = computeRelativeErrors(summaries, observations, estimator, result.config);
+    for (unsigned long i = 0; i < observations.size(); i++) {
+        result.initial_error += initial_errors[i] * initial_errors[i];
+        result.error += errors[i] * errors[i];
+        result.max_relative_error = std::max<double>(result.max_relative_error, std::fabs(errors[i]));
+    }
+    result.initial_error = std::sqrt(result.initial_error / (double)observations.size());
+    result.error = std::sqrt(result.error / (double)observations.size());
+    return result;
+}
+
+/**
+ * @brief Set the calibrated parameters of a configuration
+ *
+ * @param parameters: the parameters (see get_parameters())
+ * @param config: the platform configuration
+ */
+void PlatformCalibration::setParameters(const double *parameters, struct platform_config &config) {
+    config.task_execution_time = std::exp(parameters[0]);
+    config.io_read_speed_per_node = std::exp(parameters[1]);
+    config.io_write_speed_per_node = std::exp(parameters[2]);
+    config.io_contention_exponent = parameters[3];
+}
+
+/**
+ * @brief Fit the parameters from a starting point with the Levenberg-Marquardt algorithm: at each iteration,
+ *        the Jacobian of the relative errors is computed by forward differences, and the damping of the
+ *        Gauss-Newton step is increased until the step decreases the cost (the sum of the squared relative
+ *        errors). The fit ends when an iteration decreases the cost by less than a relative tolerance, when
+ *        no step decreases it, or after the maximum number of iterations.
+ *
+ * @param summaries: the workflow summaries
+ * @param observations: the observations
+ * @param estimator: the estimator
+ * @param initial_config: the initial platform configuration
+ * @param max_iterations: the maximum number of iterations
+ * @param parameters: the starting point, which is overwritten with the fitted parameters
+ * @param num_evaluations: the number of objective evaluations (output)
+ * @return the cost of the fitted parameters
+ */
+double PlatformCalibration::fitParameters(const std::vector<WorkflowSummary> &summaries,
+                                          const std::vector<struct calibration_observation> &observations,
+                                          const MakespanEstimator &estimator,
+                                          const struct platform_config &initial_config,
+                                          unsigned long max_iterations,
+                                          double *parameters,
+                                          unsigned long &num_evaluations) {
+    const unsigned long num_observations = observations.size();
+    double initial_parameters[NUM_CALIBRATION_PARAMETERS];
+    get_parameters(initial_config, initial_parameters);
+
+    struct platform_config config = initial_config;
+    auto evaluate = [&](const double *x, std::vector<double> &residuals) -> double {
+        setParameters(x, config);
+        residuals = computeRelativeErrors(summaries, observations, estimator, config);
+        num_evaluations++;
+        double cost = 0.0;
+        for (auto r : residuals) {
+            cost += r * r;
+        }
+        return cost;
+    };
+
+    std::vector<double> residuals;
+    std::vector<double> trial_residuals;
+    std::vector<double> jacobian(NUM_CALIBRATION_PARAMETERS * num_observations);
+    double cost = evaluate(parameters, residuals);
+    double damping = 1.0e-3;
+    for (unsigned long iteration = 0; iteration < max_iterations; iteration++) {
+        // Forward-difference Jacobian, and normal equations
+        double jtj[NUM_CALIBRATION_PARAMETERS][NUM_CALIBRATION_PARAMETERS];
+        double jtr[NUM_CALIBRATION_PARAMETERS];
+        for (int p = 0; p < NUM_CALIBRATION_PARAMETERS; p++) {
+            double x[NUM_CALIBRATION_PARAMETERS];
+            std::copy(parameters, parameters + NUM_CALIBRATION_PARAMETERS, x);
+            x[p] += CALIBRATION_DIFFERENCE_STEP;
+            evaluate(x, trial_residuals);
+            for (unsigned long i = 0; i < num_observations; i++) {
+                jacobian[p * num_observations + i] = (trial_residuals[i] - residuals[i]) / CALIBRATION_DIFFERENCE_STEP;
+            }
+        }
+        double max_gradient = 0.0;
+        for (int p = 0; p < NUM_CALIBRATION_PARAMETERS; p++) {
+            jtr[p] = 0.0;
+            for (unsigned long i = 0; i < num_observations; i++) {
+                jtr[p] += jacobian[p * num_observations + i] * residuals[i];
+            }
+            max_gradient = std::max<double>(max_gradient, std::fabs(jtr[p]));
+            for (int q = 0; q < NUM_CALIBRATION_PARAMETERS; q++) {
+                jtj[p][q] = 0.0;
+                for (unsigned long i = 0; i < num_observations; i++) {
+                    jtj[p][q] += jacobian[p * num_observations + i] * jacobian[q * num_observations + i];
+                }
+            }
+        }
+        if (max_gradient == 0.0) {
+            break;
+        }
+
+        // Increase the damping until a step decreases the cost (parameters with no effect on the estimates,
+        // whose curvature is zero, are not moved)
+        double trial_cost = cost;
+        while ((trial_cost >= cost) and (damping < CALIBRATION_MAX_DAMPING)) {
+            double a[NUM_CALIBRATION_PARAMETERS][NUM_CALIBRATION_PARAMETERS];
+            double b[NUM_CALIBRATION_PARAMETERS];
+            for (int p = 0; p < NUM_CALIBRATION_PARAMETERS; p++) {
+                for (int q = 0; q < NUM_CALIBRATION_PARAMETERS; q++) {
+                    a[p][q] = jtj[p][q];
+                }
+                a[p][p] += damping * jtj[p][p] + (jtj[p][p] == 0.0 ? 1.0 : 0.0);
+                b[p] = -jtr[p];
+            }
+            if (solve_linear_system(a, b)) {
+                double x[NUM_CALIBRATION_PARAMETERS];
+                for (int p = 0; p < NUM_CALIBRATION_PARAMETERS; p++) {
+                    x[p] = parameters[p] + b[p];
+                }
+                clamp_parameters(x, initial_parameters);
+                trial_cost = evaluate(x, trial_residuals);
+                if (trial_cost < cost) {
+                    std::copy(x, x + NUM_CALIBRATION_PARAMETERS, parameters);
+                    break;
+                }
+            }
+            damping *= 10.0;
+        }
+        if (trial_cost >= cost) {
+            break;
+        }
+        damping = std::max<double>(damping / 10.0, CALIBRATION_MIN_DAMPING);
+        residuals.swap(trial_residuals);
+        bool converged = (cost - trial_cost) <= CALIBRATION_TOLERANCE * cost;
+        cost = trial_cost;
+        if (converged) {
+            break;
+        }
+    }
+    return cost;
+}
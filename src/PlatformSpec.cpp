@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include <boost/algorithm/string.hpp>
+#include <PlatformSpec.h>
+#include <UnitParser.h>
+
+std::map<std::string, struct platform_spec> platform_specs = {
+    { "Summit",
+        {
+                40,
+                20.624, // time python3 wfbench.py --percent-cpu 0.9 --cpu-work 500 abc
+                2 * 60.0 + 47.927, // time python3 wfbench.py --percent-cpu 0.1 --cpu-work 500 abc
+                466 * MBYTE, // time dd of=/dev/zero if=test-file iflag=direct bs=128k count=4k
+                59.9 * MBYTE, // time dd if=/dev/zero of=test-file oflag=direct bs=128k count=4k
+                0.0, // page cache, local storage, and network not measured (give them in a specification string)
+                0.0,
+                0.0,
+                0.0,
+                0.0,
+                0.0
+        }
+    },
+    { "Piz Daint",
+        {
+                36,
+                7.132, // time python3 wfbench.py --percent-cpu 0.9 --cpu-work 500 abc
+                53.690, // time python3 wfbench.py --percent-cpu 0.1 --cpu-work 500 abc
+                45.3 * MBYTE, // time dd of=/dev/zero if=test-file iflag=direct bs=128k count=4k
+                13.3 * MBYTE, // time dd if=/dev/zero of=test-file oflag=direct bs=128k count=4k
+                0.0, // page cache and network not measured (give them in a specification string)
+                0.0, // no node-local storage
+                0.0,
+                0.0,
+                0.0,
+                0.0
+        }
+    }
+};
+
+/**
+ * Documentation in .h file
+ */
+struct platform_spec parse_platform_spec(const std::string &spec) {
+    struct platform_spec parsed{};
+
+    if (spec.find(':') != std::string::npos) {
+        std::vector<std::string> tokens;
+        boost::split(tokens, spec, boost::is_any_of(":"));
+        if ((tokens.size() != 5) and (tokens.size() != 6) and (tokens.size() != 8) and (tokens.size() != 11) and
+            (tokens.size() != 12)) {
+            throw std::invalid_argument("invalid platform specification " + spec);
+        }
+        parsed.cpu_task_execution_time = strtod(tokens.at(0).c_str(), nullptr);
+        parsed.mem_task_execution_time = strtod(tokens.at(1).c_str(), nullptr);
+        parsed.io_read_speed_per_node = UnitParser::parse_bandwidth(tokens.at(2));
+        parsed.io_write_speed_per_node = UnitParser::parse_bandwidth(tokens.at(3));
+        parsed.num_cores_per_node = strtoul(tokens.at(4).c_str(), nullptr, 10);
+        if (parsed.num_cores_per_node == 0) {
+            throw std::invalid_argument("invalid number of cores per node in platform specification " + spec);
+        }
+        if (tokens.size() >= 6) {
+            parsed.page_cache_size_per_node = UnitParser::parse_size(tokens.at(5));
+        }
+        if (tokens.size() >= 8) {
+            parsed.local_read_speed_per_node = UnitParser::parse_bandwidth(tokens.at(6));
+            parsed.local_write_speed_per_node = UnitParser::parse_bandwidth(tokens.at(7));
+        }
+        if (tokens.size() >= 11) {
+            parsed.network_bandwidth_per_node = UnitParser::parse_bandwidth(tokens.at(8));
+            parsed.network_latency = strtod(tokens.at(9).c_str(), nullptr);
+            parsed.bisection_bandwidth = UnitParser::parse_bandwidth(tokens.at(10));
+        }
+        if (tokens.size() == 12) {
+            parsed.io_contention_exponent = strtod(tokens.at(11).c_str(), nullptr);
+        }
+    } else if (platform_specs.find(spec) != platform_specs.end()) {
+        parsed = platform_specs[spec];
+    } else {
+        throw std::invalid_argument("invalid platform specification " + spec);
+    }
+    return parsed;
+}
+
+/**
+ * Documentation in .h file
+ */
+struct platform_config make_platform_config(const struct platform_spec &spec,
+                                            double task_execution_time,
+                                            unsigned long num_cores) {
+    if ((spec.num_cores_per_node == 0) or (num_cores == 0)) {
+        throw std::invalid_argument("make_platform_config(): the numbers of cores should be > 0");
+    }
+    struct platform_config config{};
+    config.num_cores_per_node = spec.num_cores_per_node;
+    config.num_nodes = (unsigned long)std::ceil((double)num_cores / (double)spec.num_cores_per_node);
+    config.task_execution_time = task_execution_time;
+    config.io_read_speed_per_node = spec.io_read_speed_per_node;
+    config.io_write_speed_per_node = spec.io_write_speed_per_node;
+    config.page_cache_size_per_node = spec.page_cache_size_per_node;
+    config.local_read_speed_per_node = spec.local_read_speed_per_node;
+    config.local_write_speed_per_node = spec.local_write_speed_per_node;
+    config.network_bandwidth_per_node = spec.network_bandwidth_per_node;
+    config.network_latency = spec.network_latency;
+    config.bisection_bandwidth = spec.bisection_bandwidth;
+    config.io_contention_exponent = spec.io_contention_exponent;
+    config.parallel_fraction = 1.0;
+    return config;
+}
@@ -0,0 +1,227 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+/**
+ * Python bindings (the "makespan_estimator" module, built with -DBUILD_PYTHON_BINDINGS=ON) of the workflow
+ * loader, the platform specifications, and the estimators. Per-task arrays of workflow summaries are
+ * read-only NumPy views of the summary's vectors, which keep the summary alive, and batches of estimates
+ * are computed without the GIL.
+ */
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#include <wrench-dev.h>
+#include <WfCommonsWorkflowParser.h>
+#include <PlatformSpec.h>
+#include <WorkflowSummary.h>
+#include <MakespanEstimators.h>
+#include <MakespanBounds.h>
+#include <EstimatorRegistry.h>
+
+namespace py = pybind11;
+
+/** @brief The simulation needed by WRENCH workflows, initialized when the module is imported */
+static std::shared_ptr<wrench::Simulation> simulation;
+
+/**
+ * @brief Initialize the simulation (with the GIL held, when the module is imported)
+ */
+static void init_simulation() {
+    simulation = wrench::Simulation::createSimulation();
+    int argc = 1;
+    char name[] = "makespan_estimator";
+    char *argv[] = {name, nullptr};
+    simulation->init(&argc, argv);
+}
+
+/**
+ * @brief Get a read-only NumPy view (no copy) of a vector of a workflow summary
+ *
+ * @param values: the vector
+ * @param owner: the Python object of the workflow summary, which the view keeps alive
+ * @return a NumPy array
+ */
+template <typename T>
+static py::array_t<T> create_array_view(const std::vector<T> &values, const py::object &owner) {
+    py::array_t<T> array({(py::ssize_t)values.size()}, {(py::ssize_t)sizeof(T)}, values.data(), owner);
+    array.attr("setflags")(py::arg("write") = false);
+    return array;
+}
+
+/**
+ * @brief Load a workflow, and summarize it
+ *
+ * @param path: the path to the JSON workflow description file
+ * @param overlaps: per-category overlap factors, "*" standing for other categories (empty if tasks do not
+ *                  overlap I/O and computation)
+ * @param group_tasks: whether to group identical tasks of each level
+ * @return a workflow summary
+ *
+ * @throw std::invalid_argument
+ */
+static WorkflowSummary load_workflow(const std::string &path,
+                                     const std::unordered_map<std::string, double> &overlaps,
+                                     bool group_tasks) {
+    // WRENCH files are shared by all workflows, so each loaded workflow has its own file ID prefix, and
+    // workflows (which are loaded without the GIL) are created one at a time
+    static std::atomic<unsigned long> num_workflows(0);
+    static std::mutex mutex;
+
+    std::string file_id_prefix = std::to_string(num_workflows++) + "/";
+    WorkflowSummary summary;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unordered_map<std::string, struct task_attributes> task_attributes;
+        auto workflow = WfCommonsWorkflowParser::createWorkflowFromJSON(path, 1.0, false, &task_attributes,
+                                                                        nullptr, file_id_prefix);
+        summary = WorkflowSummary::createFromWorkflow(workflow, &task_attributes, overlaps.empty() ? nullptr : &overlaps);
+    }
+    return group_tasks ? WorkflowSummary::createGrouped(summary) : summary;
+}
+
+PYBIND11_MODULE(makespan_estimator, m) {
+    m.doc() = "Makespan estimates of WfCommons workflows";
+    init_simulation();
+
+    py::class_<platform_spec>(m, "PlatformSpec")
+            .def(py::init<>())
+            .def_readwrite("num_cores_per_node", &platform_spec::num_cores_per_node)
+            .def_readwrite("cpu_task_execution_time", &platform_spec::cpu_task_execution_time)
+            .def_readwrite("mem_task_execution_time", &platform_spec::mem_task_execution_time)
+            .def_readwrite("io_read_speed_per_node", &platform_spec::io_read_speed_per_node)
+            .def_readwrite("io_write_speed_per_node", &platform_spec::io_write_speed_per_node)
+            .def_readwrite("page_cache_size_per_node", &platform_spec::page_cache_size_per_node)
+            .def_readwrite("local_read_speed_per_node", &platform_spec::local_read_speed_per_node)
+            .def_readwrite("local_write_speed_per_node", &platform_spec::local_write_speed_per_node)
+            .def_readwrite("network_bandwidth_per_node", &platform_spec::network_bandwidth_per_node)
+            .def_readwrite("network_latency", &platform_spec::network_latency)
+            .def_readwrite("bisection_bandwidth", &platform_spec::bisection_bandwidth)
+            .def_readwrite("io_contention_exponent", &platform_spec::io_contention_exponent);
+
+    py::class_<platform_config>(m, "PlatformConfig")
+            .def(py::init<>())
+            .def_readwrite("num_nodes", &platform_config::num_nodes)
+            .def_readwrite("num_cores_per_node", &platform_config::num_cores_per_node)
+            .def_readwrite("task_execution_time", &platform_config::task_execution_time)
+            .def_readwrite("io_read_speed_per_node", &platform_config::io_read_speed_per_node)
+            .def_readwrite("io_write_speed_per_node", &platform_config::io_write_speed_per_node)
+            .def_readwrite("page_cache_size_per_node", &platform_config::page_cache_size_per_node)
+            .def_readwrite("local_read_speed_per_node", &platform_config::local_read_speed_per_node)
+            .def_readwrite("local_write_speed_per_node", &platform_config::local_write_speed_per_node)
+            .def_readwrite("network_bandwidth_per_node", &platform_config::network_bandwidth_per_node)
+            .def_readwrite("network_latency", &platform_config::network_latency)
+            .def_readwrite("bisection_bandwidth", &platform_config::bisection_bandwidth)
+            .def_readwrite("io_contention_exponent", &platform_config::io_contention_exponent)
+            .def_readwrite("parallel_fraction", &platform_config::parallel_fraction);
+
+    m.def("platform_specs", []() { return platform_specs; },
+          "Get the known platform specifications, by name");
+    m.def("parse_platform_spec", &parse_platform_spec, py::arg("spec"),
+          "Parse a platform specification (a name, or a \"cpu_task_exec_time:mem_task_exec_time:...\" string)");
+    m.def("make_platform_config", [](const struct platform_spec &spec, unsigned long num_cores,
+                                     double task_execution_time, double parallel_fraction) {
+              auto config = make_platform_config(spec, task_execution_time > 0.0 ? task_execution_time :
+                                                                                    spec.cpu_task_execution_time, num_cores);
+              config.parallel_fraction = parallel_fraction;
+              return config;
+          }, py::arg("spec"), py::arg("num_cores"), py::arg("task_execution_time") = 0.0,
+          py::arg("parallel_fraction") = 1.0,
+          "Build the configuration of a platform for a total number of cores (and the platform's CPU task "
+          "execution time by default)");
+
+    py::class_<WorkflowSummary>(m, "WorkflowSummary")
+            .def_readonly("num_tasks", &WorkflowSummary::num_tasks)
+            .def_property_readonly("num_levels", &WorkflowSummary::getNumLevels)
+            .def_readonly("total_work", &WorkflowSummary::total_work)
+            .def_readonly("total_bytes_read", &WorkflowSummary::total_bytes_read)
+            .def_readonly("total_bytes_written", &WorkflowSummary::total_bytes_written)
+            .def_readonly("max_task_cores", &WorkflowSummary::max_task_cores)
+            .def_readonly("max_level_width", &WorkflowSummary::max_level_width)
+            .def_readonly("categories", &WorkflowSummary::categories)
+            .def_property_readonly("work", [](const py::object &self) {
+                return create_array_view(self.cast<const WorkflowSummary &>().work, self);
+            })
+            .def_property_readonly("bytes_read", [](const py::object &self) {
+                return create_array_view(self.cast<const WorkflowSummary &>().bytes_read, self);
+            })
+            .def_property_readonly("bytes_written", [](const py::object &self) {
+                return create_array_view(self.cast<const WorkflowSummary &>().bytes_written, self);
+            })
+            .def_property_readonly("num_cores", [](const py::object &self) {
+                return create_array_view(self.cast<const WorkflowSummary &>().num_cores, self);
+            })
+            .def_property_readonly("overlap", [](const py::object &self) {
+                return create_array_view(self.cast<const WorkflowSummary &>().overlap, self);
+            })
+            .def_property_readonly("category", [](const py::object &self) {
+                return create_array_view(self.cast<const WorkflowSummary &>().category, self);
+            })
+            .def_property_readonly("multiplicity", [](const py::object &self) {
+                return create_array_view(self.cast<const WorkflowSummary &>().multiplicity, self);
+            })
+            .def_property_readonly("level_offsets", [](const py::object &self) {
+                return create_array_view(self.cast<const WorkflowSummary &>().level_offsets, self);
+            });
+
+    m.def("load_workflow", [](const std::string &path, const std::unordered_map<std::string, double> &overlaps,
+                              bool group_tasks) {
+              py::gil_scoped_release release;
+              return load_workflow(path, overlaps, group_tasks);
+          }, py::arg("path"), py::arg("overlaps") = std::unordered_map<std::string, double>(),
+          py::arg("group_tasks") = false,
+          "Load a JSON workflow description file, and summarize it (the tasks of level l being at indices "
+          "level_offsets[l] to level_offsets[l + 1] of the per-task arrays)");
+
+    m.def("list_estimators", []() {
+              std::vector<std::pair<std::string, std::string>> estimators;
+              for (auto const &e : EstimatorRegistry::getEstimators()) {
+                  estimators.emplace_back(e->getName(), e->getDescription());
+              }
+              return estimators;
+          }, "List the (name, description) of the available estimators");
+
+    m.def("estimate_many", [](const WorkflowSummary &summary, const std::vector<struct platform_config> &configs,
+                              const std::vector<std::string> &estimator_names, unsigned long num_threads) {
+              std::vector<std::shared_ptr<MakespanEstimator>> estimators;
+              if (estimator_names.empty()) {
+                  estimators = EstimatorRegistry::getEstimators();
+              }
+              for (auto const &name : estimator_names) {
+                  estimators.push_back(EstimatorRegistry::getEstimator(name));
+              }
+
+              py::array_t<double> estimates({(py::ssize_t)configs.size(), (py::ssize_t)estimators.size()});
+              double *data = estimates.mutable_data();
+              {
+                  py::gil_scoped_release release;
+                  for (unsigned long e = 0; e < estimators.size(); e++) {
+                      auto makespans = estimators[e]->estimateBatch(summary, configs, std::max<unsigned long>(1, num_threads));
+                      for (unsigned long c = 0; c < configs.size(); c++) {
+                          data[c * estimators.size() + e] = makespans[c];
+                      }
+                  }
+              }
+              return estimates;
+          }, py::arg("summary"), py::arg("configs"), py::arg("estimators") = std::vector<std::string>(),
+          py::arg("num_threads") = std::max<unsigned long>(1, std::thread::hardware_concurrency()),
+          "Estimate the makespans of a workflow for several configurations, as a (configurations x estimators) "
+          "array (all estimators by default), on C++ threads and without the GIL");
+
+    m.def("compute_bounds", [](const WorkflowSummary &summary, const struct platform_config &config) {
+              py::gil_scoped_release release;
+              auto bounds = compute_makespan_bounds(summary, config);
+              return std::make_pair(bounds.lower, bounds.upper);
+          }, py::arg("summary"), py::arg("config"),
+          "Compute the (lower, upper) makespan bounds of a (non-grouped) workflow summary for a configuration");
+}
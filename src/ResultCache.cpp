@@ -0,0 +1,177 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <ResultCache.h>
+#include <WorkflowFingerprint.h>
+
+#define CACHE_MAGIC "WBMECACH"
+#define CACHE_HEADER_SIZE 16
+#define SLOT_WORDS 3
+
+/**
+ * Documentation in .h file
+ */
+std::unique_ptr<ResultCache> ResultCache::open(const std::string &path, unsigned long num_slots) {
+    std::unique_ptr<ResultCache> cache(new ResultCache());
+    cache->fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (cache->fd < 0) {
+        throw std::invalid_argument("ResultCache::open(): cannot open cache file " + path);
+    }
+
+    // The first process to lock an empty file initializes it. A file whose magic is missing (the file is
+    // shorter than the magic, or the magic is zeroed, bytes past the end of the file being read as zeros)
+    // is one whose initialization did not complete, and is initialized again: the magic is written last,
+    // so that it is only present once the file is fully initialized
+    flock(cache->fd, LOCK_EX);
+    struct stat st{};
+    fstat(cache->fd, &st);
+    char header[CACHE_HEADER_SIZE] = {};
+    ssize_t header_size = pread(cache->fd, header, CACHE_HEADER_SIZE, 0);
+    if (header_size < 0) {
+        flock(cache->fd, LOCK_UN);
+        throw std::invalid_argument("ResultCache::open(): cannot read cache file " + path);
+    }
+    static const char no_magic[8] = {};
+    if (memcmp(header, no_magic, 8) == 0) {
+        memcpy(header, CACHE_MAGIC, 8);
+        uint64_t n = num_slots;
+        memcpy(header + 8, &n, 8);
+        if ((ftruncate(cache->fd, 0) != 0) or
+            (ftruncate(cache->fd, (off_t)(CACHE_HEADER_SIZE + num_slots * SLOT_WORDS * 8)) != 0) or
+            (pwrite(cache->fd, header + 8, 8, 8) != 8) or
+            (fdatasync(cache->fd) != 0) or
+            (pwrite(cache->fd, header, 8, 0) != 8)) {
+            flock(cache->fd, LOCK_UN);
+            throw std::invalid_argument("ResultCache::open(): cannot initialize cache file " + path);
+        }
+        fstat(cache->fd, &st);
+        header_size = CACHE_HEADER_SIZE;
+    }
+    flock(cache->fd, LOCK_UN);
+
+    if ((header_size != CACHE_HEADER_SIZE) or (memcmp(header, CACHE_MAGIC, 8) != 0)) {
+        throw std::invalid_argument("ResultCache::open(): " + path + " is not a cache file");
+    }
+    uint64_t n;
+    memcpy(&n, header + 8, 8);
+    if ((n == 0) or ((unsigned long)st.st_size != CACHE_HEADER_SIZE + n * SLOT_WORDS * 8)) {
+        throw std::invalid_argument("ResultCache::open(): corrupted cache file " + path);
+    }
+    cache->num_slots = n;
+    cache->mapping_size = st.st_size;
+    cache->mapping = mmap(nullptr, cache->mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, cache->fd, 0);
+    if (cache->mapping == MAP_FAILED) {
+        cache->mapping = nullptr;
+        throw std::invalid_argument("ResultCache::open(): cannot map cache file " + path);
+    }
+    cache->slots = (uint64_t *)((char *)cache->mapping + CACHE_HEADER_SIZE);
+    return cache;
+}
+
+/**
+ * @brief Destructor
+ */
+ResultCache::~ResultCache() {
+    if (this->mapping) {
+        munmap(this->mapping, this->mapping_size);
+    }
+    if (this->fd >= 0) {
+        ::close(this->fd);
+    }
+}
+
+/**
+ * @brief Find the slot of a key, or the empty slot where it would be inserted
+ *
+ * @param key_low: the first word of the key hash (never 0)
+ * @param key_high: the second word of the key hash
+ * @return the slot, or nullptr if the key is not there and the table is full
+ */
+uint64_t *ResultCache::findSlot(uint64_t key_low, uint64_t key_high) const {
+    for (unsigned long i = 0; i < this->num_slots; i++) {
+        uint64_t *slot = this->slots + ((key_low + i) % this->num_slots) * SLOT_WORDS;
+        uint64_t low = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+        if ((low == 0) or ((low == key_low) and (slot[1] == key_high))) {
+            return slot;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Look up a value
+ *
+ * @param key: the key
+ * @param value: the value (output)
+ * @return true if the key is in the cache
+ */
+bool ResultCache::lookup(const std::string &key, uint64_t &value) const {
+    uint64_t key_low = WorkflowFingerprint::hash(key, 1) | 1;
+    uint64_t key_high = WorkflowFingerprint::hash(key, 2);
+    uint64_t *slot = findSlot(key_low, key_high);
+    if ((slot == nullptr) or (__atomic_load_n(slot, __ATOMIC_ACQUIRE) == 0)) {
+        return false;
+    }
+    value = slot[2];
+    return true;
+}
+
+/**
+ * @brief Look up a value
+ *
+ * @param key: the key
+ * @param value: the value (output)
+ * @return true if the key is in the cache
+ */
+bool ResultCache::lookup(const std::string &key, double &value) const {
+    uint64_t bits;
+    if (not lookup(key, bits)) {
+        return false;
+    }
+    memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+/**
+ * @brief Insert a value (keys that are already in the cache keep their value)
+ *
+ * @param key: the key
+ * @param value: the value
+ */
+void ResultCache::insert(const std::string &key, uint64_t value) {
+    uint64_t key_low = WorkflowFingerprint::hash(key, 1) | 1;
+    uint64_t key_high = WorkflowFingerprint::hash(key, 2);
+    flock(this->fd, LOCK_EX);
+    uint64_t *slot = findSlot(key_low, key_high);
+    if ((slot != nullptr) and (slot[0] == 0)) {
+        slot[2] = value;
+        slot[1] = key_high;
+        __atomic_store_n(slot, key_low, __ATOMIC_RELEASE);
+    }
+    flock(this->fd, LOCK_UN);
+}
+
+/**
+ * @brief Insert a value (keys that are already in the cache keep their value)
+ *
+ * @param key: the key
+ * @param value: the value
+ */
+void ResultCache::insert(const std::string &key, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    insert(key, bits);
+}
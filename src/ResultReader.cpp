@@ -0,0 +1,296 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+#include <ResultReader.h>
+
+/**
+ * @brief Read a whole file
+ * @param path: the file path
+ * @return the file content
+ */
+static std::string read_file(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (not file) {
+        throw std::invalid_argument("ResultReader::readResults(): cannot open file " + path);
+    }
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+/**
+ * @brief Split a CSV line into fields (handling double-quoted fields)
+ * @param line: the line
+ * @param fields: the fields (output)
+ */
+static void split_csv_line(std::string_view line, std::vector<std::string> &fields) {
+    fields.clear();
+    std::string field;
+    bool quoted = false;
+    for (unsigned long i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if (quoted) {
+            if ((c == '"') and (i + 1 < line.size()) and (line[i + 1] == '"')) {
+                field.push_back('"');
+                i++;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                field.push_back(c);
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.push_back(field);
+            field.clear();
+        } else if (c != '\r') {
+            field.push_back(c);
+        }
+    }
+    fields.push_back(field);
+}
+
+/**
+ * @brief Parse a number
+ * @param value: the string
+ * @param number: the number (output, NaN for an empty string)
+ * @return true if the whole string is a number (or empty)
+ */
+static bool parse_number(const std::string &value, double &number) {
+    if (value.empty()) {
+        number = std::nan("");
+        return true;
+    }
+    auto parsed = std::from_chars(value.data(), value.data() + value.size(), number);
+    return (parsed.ec == std::errc()) and (parsed.ptr == value.data() + value.size());
+}
+
+/**
+ * Documentation in .h file
+ */
+struct result_table ResultReader::readResults(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (not file) {
+        throw std::invalid_argument("ResultReader::readResults(): cannot open file " + path);
+    }
+    char first[8] = {0};
+    file.read(first, sizeof(first));
+    file.close();
+    if (memcmp(first, "WBMECOL1", 8) == 0) {
+        return readBinaryResults(path);
+    } else if (first[0] == '{') {
+        return readJsonLinesResults(path);
+    } else {
+        return readCsvResults(path);
+    }
+}
+
+struct result_table ResultReader::readCsvResults(const std::string &path) {
+    std::string content = read_file(path);
+    std::vector<std::vector<std::string>> rows;
+    std::vector<std::string> fields;
+    std::vector<std::string> header;
+    bool legacy = false;
+    bool prefixed = false;
+
+    std::istringstream lines(content);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.empty() or (line == "\r")) {
+            continue;
+        }
+        if (header.empty() and rows.empty() and not legacy) {
+            // A header line has no numeric field, whereas legacy lines (with or without their
+            // "CSV," prefix) do
+            split_csv_line(line, header);
+            double number;
+            legacy = (line.rfind("CSV,", 0) == 0) or
+                     std::any_of(header.begin(), header.end(), [&number](const std::string &field) {
+                         return (not field.empty()) and parse_number(field, number);
+                     });
+            if (not legacy) {
+                continue;
+            }
+            header = {"app", "num_tasks", "data_size", "type", "estimate1", "estimate2", "estimate3", "machine"};
+            prefixed = (line.rfind("CSV,", 0) == 0);
+        }
+        if (prefixed) {
+            // Legacy estimator output: only "CSV," lines are results
+            if (line.rfind("CSV,", 0) != 0) {
+                continue;
+            }
+            line = line.substr(4);
+        }
+        split_csv_line(line, fields);
+        fields.resize(header.size());
+        rows.push_back(fields);
+    }
+
+    // Columns in which all values are numbers are numeric
+    struct result_table table;
+    table.num_rows = rows.size();
+    table.strings.resize(header.size());
+    table.numbers.resize(header.size());
+    for (unsigned long c = 0; c < header.size(); c++) {
+        std::vector<double> numbers(rows.size());
+        bool numeric = true;
+        for (unsigned long r = 0; numeric and (r < rows.size()); r++) {
+            numeric = parse_number(rows[r][c], numbers[r]);
+        }
+        if (numeric) {
+            table.schema.push_back({header[c], column_type::REAL});
+            table.numbers[c] = std::move(numbers);
+        } else {
+            table.schema.push_back({header[c], column_type::STRING});
+            for (auto &row : rows) {
+                table.strings[c].push_back(std::move(row[c]));
+            }
+        }
+    }
+    return table;
+}
+
+struct result_table ResultReader::readJsonLinesResults(const std::string &path) {
+    std::ifstream file(path);
+    struct result_table table;
+    std::string line;
+    unsigned long line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        if (line.empty()) {
+            continue;
+        }
+        nlohmann::json row;
+        try {
+            row = nlohmann::json::parse(line);
+        } catch (nlohmann::json::parse_error &e) {
+            throw std::invalid_argument("ResultReader::readResults(): invalid line " + std::to_string(line_number) +
+                                        " of file " + path + " (" + e.what() + ")");
+        }
+        if (not row.is_object()) {
+            throw std::invalid_argument("ResultReader::readResults(): line " + std::to_string(line_number) +
+                                        " of file " + path + " is not a JSON object");
+        }
+        if (table.schema.empty()) {
+            for (auto it = row.begin(); it != row.end(); ++it) {
+                table.schema.push_back({it.key(), it.value().is_string() ? column_type::STRING :
+                                                  (it.value().is_number_integer() ? column_type::INTEGER : column_type::REAL)});
+            }
+            table.strings.resize(table.schema.size());
+            table.numbers.resize(table.schema.size());
+        }
+        for (unsigned long c = 0; c < table.schema.size(); c++) {
+            auto value = row.find(table.schema[c].name);
+            if (table.schema[c].type == column_type::STRING) {
+                table.strings[c].push_back(((value != row.end()) and value->is_string()) ? value->get<std::string>() : "");
+            } else {
+                table.numbers[c].push_back(((value != row.end()) and value->is_number()) ? value->get<double>() : std::nan(""));
+            }
+        }
+        table.num_rows++;
+    }
+    return table;
+}
+
+struct result_table ResultReader::readBinaryResults(const std::string &path) {
+    std::string content = read_file(path);
+    unsigned long offset = 8;
+    // Check that the file has at least size more bytes (before allocating them), and read bytes
+    auto check_size = [&content, &offset, &path](uint64_t size) {
+        if (size > content.size() - offset) {
+            throw std::invalid_argument("ResultReader::readResults(): truncated file " + path);
+        }
+    };
+    auto read = [&content, &offset, &check_size](void *destination, unsigned long size) {
+        check_size(size);
+        memcpy(destination, content.data() + offset, size);
+        offset += size;
+    };
+
+    // Read a little-endian unsigned integer
+    auto read_integer = [&read](auto &value) {
+        read(&value, sizeof(value));
+        value = convert_little_endian(value);
+    };
+
+    struct result_table table;
+    uint32_t num_columns;
+    read_integer(num_columns);
+    for (uint32_t c = 0; c < num_columns; c++) {
+        uint8_t type;
+        uint32_t name_length;
+        read(&type, sizeof(type));
+        read_integer(name_length);
+        if (type > (uint8_t)column_type::REAL) {
+            throw std::invalid_argument("ResultReader::readResults(): invalid column type in file " + path);
+        }
+        check_size(name_length);
+        std::string name(name_length, '\0');
+        read(&name[0], name_length);
+        table.schema.push_back({name, (column_type)type});
+    }
+    table.strings.resize(num_columns);
+    table.numbers.resize(num_columns);
+
+    while (offset < content.size()) {
+        uint64_t num_rows;
+        read_integer(num_rows);
+        for (uint32_t c = 0; c < num_columns; c++) {
+            // Each column has (at least) one 8-byte number or end offset per row
+            check_size(num_rows > UINT64_MAX / sizeof(uint64_t) ? UINT64_MAX : num_rows * sizeof(uint64_t));
+            if (table.schema[c].type == column_type::STRING) {
+                uint64_t num_bytes;
+                read_integer(num_bytes);
+                check_size(num_rows * sizeof(uint64_t));
+                std::vector<uint64_t> ends(num_rows);
+                read(ends.data(), num_rows * sizeof(uint64_t));
+                uint64_t previous_end = 0;
+                for (auto &end : ends) {
+                    end = convert_little_endian(end);
+                    if ((end < previous_end) or (end > num_bytes)) {
+                        throw std::invalid_argument("ResultReader::readResults(): invalid string offsets in file " + path);
+                    }
+                    previous_end = end;
+                }
+                check_size(num_bytes);
+                std::string bytes(num_bytes, '\0');
+                read(&bytes[0], num_bytes);
+                uint64_t start = 0;
+                for (auto end : ends) {
+                    table.strings[c].push_back(bytes.substr(start, end - start));
+                    start = end;
+                }
+            } else {
+                for (uint64_t r = 0; r < num_rows; r++) {
+                    uint64_t bits;
+                    read_integer(bits);
+                    if (table.schema[c].type == column_type::INTEGER) {
+                        int64_t value;
+                        memcpy(&value, &bits, sizeof(value));
+                        table.numbers[c].push_back((double)value);
+                    } else {
+                        double value;
+                        memcpy(&value, &bits, sizeof(value));
+                        table.numbers[c].push_back(value);
+                    }
+                }
+            }
+        }
+        table.num_rows += num_rows;
+    }
+    return table;
+}
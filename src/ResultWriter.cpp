@@ -0,0 +1,390 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <ResultWriter.h>
+
+// Size above which the output buffer is written out
+#define RESULT_BUFFER_SIZE (1024 * 1024)
+// Number of rows in each row group of the binary format
+#define RESULT_ROW_GROUP_SIZE 65536
+
+/**
+ * @brief Constructor
+ * @param path: the output file path ("-" for stdout)
+ * @param schema: the result columns
+ *
+ * @throw std::invalid_argument
+ */
+ResultWriter::ResultWriter(const std::string &path, const std::vector<struct result_column> &schema) : schema(schema) {
+    if (schema.empty()) {
+        throw std::invalid_argument("ResultWriter::ResultWriter(): empty schema");
+    }
+    if (path == "-") {
+        this->file = stdout;
+    } else {
+        this->file = fopen(path.c_str(), "wb");
+        if (this->file == nullptr) {
+            throw std::invalid_argument("ResultWriter::ResultWriter(): cannot open output file " + path);
+        }
+    }
+    this->buffer.reserve(RESULT_BUFFER_SIZE + 4096);
+}
+
+/**
+ * @brief Destructor (which closes the writer if needed)
+ */
+ResultWriter::~ResultWriter() {
+    // close() cannot be called here, as writeEnd() is a virtual method of an already destroyed subclass,
+    // and so subclasses call close() in their destructors
+    if (not this->closed) {
+        flushBuffer();
+        if (this->file != stdout) {
+            fclose(this->file);
+        }
+    }
+}
+
+/**
+ * @brief Flush all rows and close the output file
+ */
+void ResultWriter::close() {
+    if (this->closed) {
+        return;
+    }
+    if (this->current_column != 0) {
+        throw std::runtime_error("ResultWriter::close(): incomplete row");
+    }
+    writeEnd();
+    flushBuffer();
+    if (this->file == stdout) {
+        fflush(stdout);
+    } else {
+        fclose(this->file);
+    }
+    this->closed = true;
+}
+
+void ResultWriter::checkColumn(column_type type) {
+    if (this->current_column >= this->schema.size()) {
+        throw std::invalid_argument("ResultWriter: too many values in row");
+    }
+    if (this->schema[this->current_column].type != type) {
+        throw std::invalid_argument("ResultWriter: invalid value type for column " + this->schema[this->current_column].name);
+    }
+}
+
+/**
+ * @brief Add a string value to the current row
+ * @param value: the value
+ */
+void ResultWriter::addString(std::string_view value) {
+    checkColumn(column_type::STRING);
+    writeString(value);
+    this->current_column++;
+}
+
+/**
+ * @brief Add an integer value to the current row
+ * @param value: the value
+ */
+void ResultWriter::addInteger(int64_t value) {
+    checkColumn(column_type::INTEGER);
+    writeInteger(value);
+    this->current_column++;
+}
+
+/**
+ * @brief Add a real value to the current row
+ * @param value: the value
+ */
+void ResultWriter::addReal(double value) {
+    checkColumn(column_type::REAL);
+    writeReal(value);
+    this->current_column++;
+}
+
+/**
+ * @brief End the current row
+ */
+void ResultWriter::endRow() {
+    if (this->current_column != this->schema.size()) {
+        throw std::invalid_argument("ResultWriter::endRow(): missing values in row");
+    }
+    writeEndRow();
+    this->current_column = 0;
+    if (this->buffer.size() >= RESULT_BUFFER_SIZE) {
+        flushBuffer();
+    }
+}
+
+void ResultWriter::append(std::string_view bytes) {
+    this->buffer.append(bytes.data(), bytes.size());
+}
+
+void ResultWriter::flushBuffer() {
+    if (not this->buffer.empty()) {
+        fwrite(this->buffer.data(), 1, this->buffer.size(), this->file);
+        this->buffer.clear();
+    }
+}
+
+/**
+ * @brief Append a number, in its shortest round-trip representation, to a string
+ */
+template <class T>
+static void append_number(std::string &buffer, T value) {
+    char digits[64];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer.append(digits, result.ptr - digits);
+}
+
+/**
+ * @brief Append a quoted and escaped JSON string to a string
+ */
+static void append_json_string(std::string &buffer, std::string_view value) {
+    buffer.push_back('"');
+    for (auto c : value) {
+        switch (c) {
+            case '"': buffer.append("\\\""); break;
+            case '\\': buffer.append("\\\\"); break;
+            case '\n': buffer.append("\\n"); break;
+            case '\t': buffer.append("\\t"); break;
+            case '\r': buffer.append("\\r"); break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    buffer.append(escaped);
+                } else {
+                    buffer.push_back(c);
+                }
+        }
+    }
+    buffer.push_back('"');
+}
+
+/**
+ * @brief A CSV result writer
+ */
+class CsvResultWriter : public ResultWriter {
+public:
+    CsvResultWriter(const std::string &path, const std::vector<struct result_column> &schema) : ResultWriter(path, schema) {
+        for (unsigned long i = 0; i < schema.size(); i++) {
+            if (i > 0) {
+                append(",");
+            }
+            writeField(schema[i].name);
+        }
+        append("\n");
+    }
+
+    ~CsvResultWriter() override {
+        try {
+            close();
+        } catch (std::exception &ignore) {
+        }
+    }
+
+protected:
+    void separator() {
+        if (this->current_column > 0) {
+            this->buffer.push_back(',');
+        }
+    }
+
+    void writeField(std::string_view value) {
+        if (value.find_first_of(",\"\n") == std::string_view::npos) {
+            append(value);
+            return;
+        }
+        this->buffer.push_back('"');
+        for (auto c : value) {
+            if (c == '"') {
+                this->buffer.push_back('"');
+            }
+            this->buffer.push_back(c);
+        }
+        this->buffer.push_back('"');
+    }
+
+    void writeString(std::string_view value) override {
+        separator();
+        writeField(value);
+    }
+
+    void writeInteger(int64_t value) override {
+        separator();
+        append_number(this->buffer, value);
+    }
+
+    void writeReal(double value) override {
+        separator();
+        append_number(this->buffer, value);
+    }
+
+    void writeEndRow() override {
+        this->buffer.push_back('\n');
+    }
+};
+
+/**
+ * @brief A JSON-lines result writer
+ */
+class JsonLinesResultWriter : public ResultWriter {
+public:
+    JsonLinesResultWriter(const std::string &path, const std::vector<struct result_column> &schema) : ResultWriter(path, schema) {
+        // Pre-format the "key": prefixes
+        for (unsigned long i = 0; i < schema.size(); i++) {
+            std::string key = (i == 0 ? "{" : ",");
+            append_json_string(key, schema[i].name);
+            this->keys.push_back(key + ":");
+        }
+    }
+
+    ~JsonLinesResultWriter() override {
+        try {
+            close();
+        } catch (std::exception &ignore) {
+        }
+    }
+
+protected:
+    void writeString(std::string_view value) override {
+        append(this->keys[this->current_column]);
+        append_json_string(this->buffer, value);
+    }
+
+    void writeInteger(int64_t value) override {
+        append(this->keys[this->current_column]);
+        append_number(this->buffer, value);
+    }
+
+    void writeReal(double value) override {
+        append(this->keys[this->current_column]);
+        if (std::isfinite(value)) {
+            append_number(this->buffer, value);
+        } else {
+            append("null");
+        }
+    }
+
+    void writeEndRow() override {
+        append("}\n");
+    }
+
+private:
+    std::vector<std::string> keys;
+};
+
+/**
+ * @brief A columnar binary result writer (format described in the .h file)
+ */
+class BinaryResultWriter : public ResultWriter {
+public:
+    BinaryResultWriter(const std::string &path, const std::vector<struct result_column> &schema) :
+            ResultWriter(path, schema), numbers(schema.size()), strings(schema.size()), string_ends(schema.size()) {
+        append("WBMECOL1");
+        appendRaw((uint32_t)schema.size());
+        for (auto const &c : schema) {
+            appendRaw((uint8_t)c.type);
+            appendRaw((uint32_t)c.name.size());
+            append(c.name);
+        }
+    }
+
+    ~BinaryResultWriter() override {
+        try {
+            close();
+        } catch (std::exception &ignore) {
+        }
+    }
+
+protected:
+    template <class T>
+    void appendRaw(T value) {
+        value = convert_little_endian(value);
+        this->buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    void writeString(std::string_view value) override {
+        this->strings[this->current_column].append(value.data(), value.size());
+        this->string_ends[this->current_column].push_back(convert_little_endian((uint64_t)this->strings[this->current_column].size()));
+    }
+
+    void writeInteger(int64_t value) override {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        this->numbers[this->current_column].push_back(convert_little_endian(bits));
+    }
+
+    void writeReal(double value) override {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        this->numbers[this->current_column].push_back(convert_little_endian(bits));
+    }
+
+    void writeEndRow() override {
+        if (++this->num_rows == RESULT_ROW_GROUP_SIZE) {
+            writeRowGroup();
+        }
+    }
+
+    void writeEnd() override {
+        if (this->num_rows > 0) {
+            writeRowGroup();
+        }
+    }
+
+private:
+    void writeRowGroup() {
+        appendRaw((uint64_t)this->num_rows);
+        for (unsigned long i = 0; i < this->schema.size(); i++) {
+            if (this->schema[i].type == column_type::STRING) {
+                appendRaw((uint64_t)this->strings[i].size());
+                this->buffer.append(reinterpret_cast<const char *>(this->string_ends[i].data()),
+                                    this->string_ends[i].size() * sizeof(uint64_t));
+                append(this->strings[i]);
+                this->strings[i].clear();
+                this->string_ends[i].clear();
+            } else {
+                this->buffer.append(reinterpret_cast<const char *>(this->numbers[i].data()),
+                                    this->numbers[i].size() * sizeof(uint64_t));
+                this->numbers[i].clear();
+            }
+        }
+        this->num_rows = 0;
+        flushBuffer();
+    }
+
+    unsigned long num_rows = 0;
+    std::vector<std::vector<uint64_t>> numbers;
+    std::vector<std::string> strings;
+    std::vector<std::vector<uint64_t>> string_ends;
+};
+
+/**
+ * Documentation in .h file
+ */
+std::unique_ptr<ResultWriter> ResultWriter::createResultWriter(const std::string &format,
+                                                               const std::string &path,
+                                                               const std::vector<struct result_column> &schema) {
+    if (format == "csv") {
+        return std::unique_ptr<ResultWriter>(new CsvResultWriter(path, schema));
+    } else if (format == "jsonl") {
+        return std::unique_ptr<ResultWriter>(new JsonLinesResultWriter(path, schema));
+    } else if (format == "binary") {
+        return std::unique_ptr<ResultWriter>(new BinaryResultWriter(path, schema));
+    } else {
+        throw std::invalid_argument("ResultWriter::createResultWriter(): unknown output format " + format);
+    }
+}
@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <MakespanEstimators.h>
+#include <SensitivityAnalysis.h>
+
+/**
+ * @brief Get the value of a parameter in a configuration
+ *
+ * @param config: the platform configuration
+ * @param parameter: the parameter
+ * @return the value of the parameter
+ */
+static double get_parameter_value(const struct platform_config &config, int parameter) {
+    switch (parameter) {
+        case TASK_EXECUTION_TIME:
+            return config.task_execution_time;
+        case IO_READ_SPEED:
+            return config.io_read_speed_per_node;
+        case IO_WRITE_SPEED:
+            return config.io_write_speed_per_node;
+        default:
+            return (double)(config.num_nodes * config.num_cores_per_node);
+    }
+}
+
+/**
+ * Documentation in .h file
+ */
+std::vector<struct platform_config> SensitivityAnalysis::getPerturbedConfigs(const struct platform_config &config,
+                                                                             double relative_step) {
+    if ((relative_step <= 0.0) or (relative_step >= 1.0)) {
+        throw std::invalid_argument("SensitivityAnalysis::getPerturbedConfigs(): the relative step must be between 0 and 1");
+    }
+
+    std::vector<struct platform_config> configs(2 * NUM_SENSITIVITY_PARAMETERS, config);
+    configs[2 * TASK_EXECUTION_TIME].task_execution_time *= 1.0 + relative_step;
+    configs[2 * TASK_EXECUTION_TIME + 1].task_execution_time *= 1.0 - relative_step;
+    configs[2 * IO_READ_SPEED].io_read_speed_per_node *= 1.0 + relative_step;
+    configs[2 * IO_READ_SPEED + 1].io_read_speed_per_node *= 1.0 - relative_step;
+    configs[2 * IO_WRITE_SPEED].io_write_speed_per_node *= 1.0 + relative_step;
+    configs[2 * IO_WRITE_SPEED + 1].io_write_speed_per_node *= 1.0 - relative_step;
+    // The number of cores only changes by whole nodes (and with a single node, the difference is one-sided)
+    configs[2 * NUM_CORES].num_nodes += 1;
+    configs[2 * NUM_CORES + 1].num_nodes = std::max<unsigned long>(1, config.num_nodes - 1);
+    return configs;
+}
+
+/**
+ * Documentation in .h file
+ */
+struct makespan_sensitivity SensitivityAnalysis::computeSensitivity(const struct platform_config &config,
+                                                                    double relative_step,
+                                                                    double makespan,
+                                                                    const double *perturbed_makespans) {
+    auto configs = getPerturbedConfigs(config, relative_step);
+
+    struct makespan_sensitivity sensitivity{};
+    sensitivity.makespan = makespan;
+    for (int p = 0; p < NUM_SENSITIVITY_PARAMETERS; p++) {
+        double value = get_parameter_value(config, p);
+        double delta = get_parameter_value(configs[2 * p], p) - get_parameter_value(configs[2 * p + 1], p);
+        if ((makespan > 0.0) and (delta > 0.0)) {
+            sensitivity.elasticities[p] = ((perturbed_makespans[2 * p] - perturbed_makespans[2 * p + 1]) / makespan) /
+                                          (delta / value);
+        }
+    }
+    return sensitivity;
+}
+
+/**
+ * Documentation in .h file
+ */
+std::vector<struct makespan_sensitivity> SensitivityAnalysis::analyzeLevels(const WorkflowSummary &summary,
+                                                                            const struct platform_config &config,
+                                                                            double relative_step,
+                                                                            unsigned long num_threads) {
+    auto configs = getPerturbedConfigs(config, relative_step);
+    configs.insert(configs.begin(), config);
+
+    const unsigned long num_levels = summary.getNumLevels();
+    std::vector<struct makespan_sensitivity> sensitivities(num_levels);
+
+    // Each thread takes the next level, and estimates it for all configurations
+    std::atomic<unsigned long> next(0);
+    auto analyze = [&]() {
+        EstimationWorkspace workspace(summary);
+        std::vector<double> makespans(configs.size());
+        for (unsigned long level = next++; level < num_levels; level = next++) {
+            for (unsigned long c = 0; c < configs.size(); c++) {
+                makespans[c] = estimate_makespan_level(summary, level, configs[c], workspace);
+            }
+            sensitivities[level] = computeSensitivity(config, relative_step, makespans[0], makespans.data() + 1);
+        }
+    };
+    num_threads = std::max<unsigned long>(1, std::min<unsigned long>(num_threads, num_levels));
+    std::vector<std::thread> workers;
+    for (unsigned long t = 1; t < num_threads; t++) {
+        workers.emplace_back(analyze);
+    }
+    analyze();
+    for (auto &w : workers) {
+        w.join();
+    }
+    return sensitivities;
+}
+
+/**
+ * Documentation in .h file
+ */
+std::array<enum sensitivity_parameter, NUM_SENSITIVITY_PARAMETERS> SensitivityAnalysis::rankParameters(
+        const struct makespan_sensitivity &sensitivity) {
+    std::array<enum sensitivity_parameter, NUM_SENSITIVITY_PARAMETERS> ranking = {
+            TASK_EXECUTION_TIME, IO_READ_SPEED, IO_WRITE_SPEED, NUM_CORES};
+    std::stable_sort(ranking.begin(), ranking.end(), [&sensitivity](enum sensitivity_parameter a, enum sensitivity_parameter b) {
+        return std::abs(sensitivity.elasticities[a]) > std::abs(sensitivity.elasticities[b]);
+    });
+    return ranking;
+}
+
+/**
+ * Documentation in .h file
+ */
+std::string SensitivityAnalysis::getParameterName(enum sensitivity_parameter parameter) {
+    const char *names[NUM_SENSITIVITY_PARAMETERS] = {"cpu", "read", "write", "cores"};
+    return names[parameter];
+}
@@ -0,0 +1,237 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <SimulationFarm.h>
+
+/**
+ * @brief An execution controller that runs the tasks of a workflow on a compute service as soon as they
+ *        are ready, reading and writing all files from/to a storage service
+ */
+class SimulationController : public wrench::ExecutionController {
+
+public:
+    SimulationController(const std::shared_ptr<wrench::Workflow> &workflow,
+                         const std::shared_ptr<wrench::ComputeService> &compute_service,
+                         const std::shared_ptr<wrench::StorageService> &storage_service,
+                         const std::string &hostname) :
+            wrench::ExecutionController(hostname, "simulation_controller"),
+            workflow(workflow), compute_service(compute_service), storage_service(storage_service) {}
+
+protected:
+    /**
+     * @brief A task failure means that the platform cannot run the workflow (e.g., too few cores)
+     * @param event: the failure event
+     */
+    void processEventStandardJobFailure(std::shared_ptr<wrench::StandardJobFailedEvent> event) override {
+        throw std::runtime_error("a job failed: " + event->failure_cause->toString());
+    }
+
+private:
+    int main() override {
+        auto job_manager = this->createJobManager();
+        while (not this->workflow->isDone()) {
+            // The compute service queues jobs until cores are available
+            for (auto const &task : this->workflow->getReadyTasks()) {
+                std::map<std::shared_ptr<wrench::DataFile>, std::shared_ptr<wrench::FileLocation>> file_locations;
+                for (auto const &f : task->getInputFiles()) {
+                    file_locations[f] = wrench::FileLocation::LOCATION(this->storage_service, f);
+                }
+                for (auto const &f : task->getOutputFiles()) {
+                    file_locations[f] = wrench::FileLocation::LOCATION(this->storage_service, f);
+                }
+                auto job = job_manager->createStandardJob(task, file_locations);
+                job_manager->submitJob(job, this->compute_service);
+            }
+            this->waitForAndProcessNextEvent();
+        }
+        return 0;
+    }
+
+    std::shared_ptr<wrench::Workflow> workflow;
+    std::shared_ptr<wrench::ComputeService> compute_service;
+    std::shared_ptr<wrench::StorageService> storage_service;
+};
+
+/**
+ * @brief Write the SimGrid platform file of a configuration
+ *
+ * @param config: the platform configuration
+ * @return the path to the (temporary) platform file
+ *
+ * @throw std::invalid_argument
+ */
+std::string SimulationFarm::createPlatformFile(const struct platform_config &config) {
+    std::string path = (std::filesystem::temp_directory_path() /
+                        ("simulation-platform-" + std::to_string(getpid()) + ".xml")).string();
+    std::ofstream file(path);
+    if (not file) {
+        throw std::invalid_argument("SimulationFarm::createPlatformFile(): cannot create " + path);
+    }
+
+    char line[512];
+    file << "<?xml version='1.0'?>\n"
+            "<!DOCTYPE platform SYSTEM \"https://simgrid.org/simgrid.dtd\">\n"
+            "<platform version=\"4.1\">\n"
+            "  <zone id=\"AS0\" routing=\"Full\">\n";
+    snprintf(line, sizeof(line),
+             "    <host id=\"storage\" speed=\"1f\" core=\"1\">\n"
+             "      <disk id=\"disk\" read_bw=\"%.17gBps\" write_bw=\"%.17gBps\">\n"
+             "        <prop id=\"size\" value=\"1000000TB\"/>\n"
+             "        <prop id=\"mount\" value=\"/\"/>\n"
+             "      </disk>\n"
+             "    </host>\n",
+             config.io_read_speed_per_node * (double)config.num_nodes,
+             config.io_write_speed_per_node * (double)config.num_nodes);
+    file << line;
+    file << "    <host id=\"controller\" speed=\"1f\" core=\"1\"/>\n";
+    for (unsigned long n = 0; n < config.num_nodes; n++) {
+        snprintf(line, sizeof(line), "    <host id=\"node%lu\" speed=\"%.17gf\" core=\"%lu\"/>\n",
+                 n, 1.0 / config.task_execution_time, config.num_cores_per_node);
+        file << line;
+    }
+
+    // Per-node links to the storage host, and a (fast) control link to the controller
+    for (unsigned long n = 0; n < config.num_nodes; n++) {
+        snprintf(line, sizeof(line), "    <link id=\"link%lu\" bandwidth=\"%.17gBps\" latency=\"0us\"/>\n",
+                 n, std::max(config.io_read_speed_per_node, config.io_write_speed_per_node));
+        file << line;
+    }
+    file << "    <link id=\"control\" bandwidth=\"100GBps\" latency=\"0us\"/>\n";
+    file << "    <route src=\"controller\" dst=\"storage\"><link_ctn id=\"control\"/></route>\n";
+    for (unsigned long n = 0; n < config.num_nodes; n++) {
+        snprintf(line, sizeof(line),
+                 "    <route src=\"storage\" dst=\"node%lu\"><link_ctn id=\"link%lu\"/></route>\n"
+                 "    <route src=\"controller\" dst=\"node%lu\"><link_ctn id=\"control\"/></route>\n",
+                 n, n, n);
+        file << line;
+    }
+    file << "  </zone>\n"
+            "</platform>\n";
+    file.close();
+    if (not file) {
+        throw std::invalid_argument("SimulationFarm::createPlatformFile(): cannot write " + path);
+    }
+    return path;
+}
+
+/**
+ * @brief Run a simulation (in a worker process, as a process can only run one)
+ *
+ * @param simulation: the simulation
+ * @param workflow: the workflow
+ * @param config: the platform configuration
+ * @return the simulated makespan, in seconds
+ */
+double SimulationFarm::simulateOne(const std::shared_ptr<wrench::Simulation> &simulation,
+                                   const std::shared_ptr<wrench::Workflow> &workflow,
+                                   const struct platform_config &config) {
+    std::string platform_file = createPlatformFile(config);
+    simulation->instantiatePlatform(platform_file);
+    std::filesystem::remove(platform_file);
+
+    std::vector<std::string> compute_hosts;
+    for (unsigned long n = 0; n < config.num_nodes; n++) {
+        compute_hosts.push_back("node" + std::to_string(n));
+    }
+    auto storage_service = simulation->add(
+            wrench::SimpleStorageService::createSimpleStorageService("storage", {"/"}, {}, {}));
+    auto compute_service = simulation->add(
+            new wrench::BareMetalComputeService("controller", compute_hosts, "", {}, {}));
+    simulation->add(new SimulationController(workflow, compute_service, storage_service, "controller"));
+    for (auto const &f : workflow->getInputFiles()) {
+        storage_service->createFile(f);
+    }
+
+    simulation->launch();
+    return workflow->getCompletionDate();
+}
+
+/**
+ * Documentation in .h file
+ */
+std::vector<struct simulation_result> SimulationFarm::simulate(
+        const std::shared_ptr<wrench::Simulation> &simulation,
+        const std::shared_ptr<wrench::Workflow> &workflow,
+        const std::vector<struct platform_config> &configs,
+        unsigned long num_workers,
+        const std::function<void(unsigned long, const struct simulation_result &)> &callback) {
+
+    if (num_workers == 0) {
+        throw std::invalid_argument("SimulationFarm::simulate(): the number of workers must be positive");
+    }
+
+    std::vector<struct simulation_result> results(configs.size(), {-1.0, 0.0});
+    // Running workers: pid -> (configuration index, read end of the result pipe)
+    std::map<pid_t, std::pair<unsigned long, int>> workers;
+    unsigned long next = 0;
+    while ((next < configs.size()) or (not workers.empty())) {
+
+        while ((next < configs.size()) and (workers.size() < num_workers)) {
+            int fds[2];
+            if (pipe(fds) != 0) {
+                throw std::invalid_argument("SimulationFarm::simulate(): cannot create a pipe");
+            }
+            // Buffered output would otherwise be written by both processes
+            fflush(nullptr);
+            pid_t pid = fork();
+            if (pid < 0) {
+                throw std::invalid_argument("SimulationFarm::simulate(): cannot fork a worker");
+            }
+            if (pid == 0) {
+                close(fds[0]);
+                struct simulation_result result = {-1.0, 0.0};
+                auto start = std::chrono::steady_clock::now();
+                try {
+                    result.makespan = simulateOne(simulation, workflow, configs[next]);
+                } catch (std::exception &e) {
+                    fprintf(stderr, "Error: simulation %lu failed: %s\n", next, e.what());
+                }
+                result.wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                ssize_t written = write(fds[1], &result, sizeof(result));
+                // Exit without running the parent's destructors or flushing its buffers
+                _exit(written == sizeof(result) ? 0 : 1);
+            }
+            close(fds[1]);
+            workers[pid] = {next, fds[0]};
+            next++;
+        }
+
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if ((pid < 0) and (errno != EINTR)) {
+            throw std::invalid_argument("SimulationFarm::simulate(): cannot wait for workers");
+        }
+        auto it = workers.find(pid);
+        if (it == workers.end()) {
+            continue;
+        }
+        // A worker that crashed sends no result, and its configuration keeps a failed result
+        unsigned long index = it->second.first;
+        struct simulation_result result = {-1.0, 0.0};
+        if (read(it->second.second, &result, sizeof(result)) == sizeof(result)) {
+            results[index] = result;
+        }
+        close(it->second.second);
+        workers.erase(it);
+        if (callback) {
+            callback(index, results[index]);
+        }
+    }
+    return results;
+}
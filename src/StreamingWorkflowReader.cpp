@@ -0,0 +1,436 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <unistd.h>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+#include <StreamingWorkflowReader.h>
+
+// Size of the stdio buffers of spill files
+#define SPILL_BUFFER_SIZE (4UL * 1024 * 1024)
+
+/**
+ * @brief A buffered spill file
+ */
+class SpillFile {
+public:
+    /**
+     * @brief Open a spill file
+     * @param path: the path of the file
+     * @param mode: "wb" or "rb"
+     */
+    SpillFile(const std::string &path, const char *mode) : buffer(SPILL_BUFFER_SIZE) {
+        file = fopen(path.c_str(), mode);
+        if (file == nullptr) {
+            throw std::invalid_argument("StreamingWorkflowReader: cannot open spill file " + path);
+        }
+        setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+    }
+
+    ~SpillFile() {
+        fclose(file);
+    }
+
+    void write(const void *data, size_t size) {
+        if (fwrite(data, 1, size, file) != size) {
+            throw std::invalid_argument("StreamingWorkflowReader: cannot write spill file (disk full?)");
+        }
+    }
+
+    /**
+     * @brief Read from the file
+     * @return false at the end of the file
+     */
+    bool read(void *data, size_t size) {
+        if (size == 0) {
+            return true;
+        }
+        size_t n = fread(data, 1, size, file);
+        if ((n != 0) and (n != size)) {
+            throw std::invalid_argument("StreamingWorkflowReader: truncated spill file");
+        }
+        return n == size;
+    }
+
+    void flush() {
+        if (fflush(file) != 0) {
+            throw std::invalid_argument("StreamingWorkflowReader: cannot write spill file (disk full?)");
+        }
+    }
+
+private:
+    FILE *file;
+    std::vector<char> buffer;
+};
+
+/**
+ * @brief The per-task data of a task record of the task spill file (which is followed by the task name)
+ */
+struct task_record {
+    double bytes_read;
+    double bytes_written;
+    uint64_t num_cores;
+    uint64_t category;
+    uint64_t name_length;
+};
+
+/**
+ * @brief A dependency of the dependency spill file
+ */
+struct dependency_record {
+    uint64_t parent_name_hash;
+    uint64_t child;
+};
+
+/**
+ * @brief Create an empty spill file
+ * @param spill_directory: the directory of the file
+ * @param suffix: the file name suffix
+ * @return the path of the file
+ */
+static std::string create_spill_file(const std::string &spill_directory, const std::string &suffix) {
+    std::string path = spill_directory + "/workflow-spill-XXXXXX" + suffix;
+    std::vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+    int fd = mkstemps(name.data(), (int)suffix.size());
+    if (fd < 0) {
+        throw std::invalid_argument("StreamingWorkflowReader: cannot create a spill file in " + spill_directory);
+    }
+    close(fd);
+    return {name.data()};
+}
+
+/**
+ * Documentation in .h file
+ */
+std::unique_ptr<StreamingWorkflowReader> StreamingWorkflowReader::createFromJSON(const std::string &filename,
+                                                                                 const std::string &spill_directory,
+                                                                                 unsigned long memory_budget) {
+    std::unique_ptr<StreamingWorkflowReader> reader(new StreamingWorkflowReader());
+    reader->memory_budget = memory_budget;
+    reader->task_file_path = create_spill_file(spill_directory, "-tasks.bin");
+    reader->dependency_file_path = create_spill_file(spill_directory, "-dependencies.bin");
+
+    std::ifstream file(filename);
+    if (not file.is_open()) {
+        throw std::invalid_argument("StreamingWorkflowReader::createFromJSON(): Invalid Json file");
+    }
+
+    // Parse tasks one at a time (tasks are discarded from the JSON DOM once spilled), as the in-memory parser does
+    std::vector<uint64_t> name_hashes;
+    unsigned long num_dependencies = 0;
+    std::unordered_map<std::string, unsigned long> category_indices = {{"", 0}};
+    reader->totals.categories.emplace_back("");
+    {
+        SpillFile tasks(reader->task_file_path, "wb");
+        SpillFile dependencies(reader->dependency_file_path, "wb");
+        std::string top_level_key;
+        std::string workflow_key;
+        std::vector<std::pair<std::string, double>> input_files;
+        std::vector<std::pair<std::string, double>> output_files;
+
+        auto spill_task = [&](const nlohmann::json &job) {
+            std::string name = job.at("name");
+            reader->fingerprint.addTask(job);
+
+            unsigned long min_num_cores = 1;
+            if (job.contains("cores")) {
+                min_num_cores = job.at("cores").get<unsigned long>();
+            }
+            if (job.contains("min_cores")) {
+                min_num_cores = job.at("min_cores").get<unsigned long>();
+            }
+
+            std::string category;
+            if (job.contains("category")) {
+                category = job.at("category").get<std::string>();
+            } else {
+                category = name.substr(0, name.find_last_of('_') == std::string::npos ? name.size() : name.find_last_of('_'));
+            }
+            auto c = category_indices.emplace(category, reader->totals.categories.size());
+            if (c.second) {
+                reader->totals.categories.push_back(category);
+            }
+
+            // Files are summed in file ID order, each file once, as for wrench::WorkflowTask input/output files
+            input_files.clear();
+            output_files.clear();
+            for (auto const &f : job.at("files")) {
+                std::string link = f.at("link");
+                if (link == "input") {
+                    input_files.emplace_back(f.at("name").get<std::string>(), f.at("size").get<double>());
+                } else if (link == "output") {
+                    output_files.emplace_back(f.at("name").get<std::string>(), f.at("size").get<double>());
+                }
+            }
+            auto sum_sizes = [](std::vector<std::pair<std::string, double>> &files) -> double {
+                std::stable_sort(files.begin(), files.end(), [](const std::pair<std::string, double> &a, const std::pair<std::string, double> &b) {
+                    return a.first < b.first;
+                });
+                double sum = 0.0;
+                for (unsigned long i = 0; i < files.size(); i++) {
+                    if ((i == 0) or (files[i].first != files[i - 1].first)) {
+                        sum += files[i].second;
+                    }
+                }
+                return sum;
+            };
+
+            struct task_record record{};
+            record.bytes_read = sum_sizes(input_files);
+            record.bytes_written = sum_sizes(output_files);
+            record.num_cores = std::max<unsigned long>(1, min_num_cores);
+            record.category = c.first->second;
+            record.name_length = name.size();
+            tasks.write(&record, sizeof(record));
+            tasks.write(name.data(), name.size());
+
+            for (auto const &parent : job.at("parents")) {
+                struct dependency_record dependency{};
+                dependency.parent_name_hash = std::hash<std::string>()(parent.get<std::string>());
+                dependency.child = name_hashes.size();
+                dependencies.write(&dependency, sizeof(dependency));
+                num_dependencies++;
+            }
+            name_hashes.push_back(std::hash<std::string>()(name));
+        };
+
+        nlohmann::json::parser_callback_t callback = [&](int depth, nlohmann::json::parse_event_t event, nlohmann::json &parsed) -> bool {
+            if (event == nlohmann::json::parse_event_t::key) {
+                if (depth == 1) {
+                    top_level_key = parsed.get<std::string>();
+                } else if (depth == 2) {
+                    workflow_key = parsed.get<std::string>();
+                }
+            } else if ((event == nlohmann::json::parse_event_t::object_end) and (depth == 3) and
+                       (top_level_key == "workflow") and (workflow_key == "tasks")) {
+                spill_task(parsed);
+                return false;
+            }
+            return true;
+        };
+
+        nlohmann::json j;
+        try {
+            j = nlohmann::json::parse(file, callback);
+        } catch (nlohmann::json::exception &e) {
+            throw std::invalid_argument("StreamingWorkflowReader::createFromJSON(): Invalid Json file (" + std::string(e.what()) + ")");
+        }
+        if (not j.contains("workflow")) {
+            throw std::invalid_argument("StreamingWorkflowReader::createFromJSON(): Could not find a workflow exit");
+        }
+        tasks.flush();
+        dependencies.flush();
+    }
+
+    reader->computeLevels(name_hashes, num_dependencies);
+    name_hashes.clear();
+    name_hashes.shrink_to_fit();
+
+    // Totals are summed in level order, as WorkflowSummary::createFromWorkflow() does
+    WorkflowSummary &totals = reader->totals;
+    totals.num_tasks = reader->levels.size();
+    totals.max_level_width = reader->level_widths.empty() ? 0 : *std::max_element(reader->level_widths.begin(), reader->level_widths.end());
+    reader->forEachLevel([&totals](const WorkflowSummary &level_summary) {
+        for (unsigned long t = 0; t < level_summary.getNumTasks(); t++) {
+            totals.total_work += level_summary.work[t];
+            totals.total_bytes_read += level_summary.bytes_read[t];
+            totals.total_bytes_written += level_summary.bytes_written[t];
+            totals.max_task_cores = std::max<unsigned long>(totals.max_task_cores, level_summary.num_cores[t]);
+        }
+    });
+
+    return reader;
+}
+
+/**
+ * @brief Destructor, which removes the spill files
+ */
+StreamingWorkflowReader::~StreamingWorkflowReader() {
+    unlink(this->task_file_path.c_str());
+    unlink(this->dependency_file_path.c_str());
+}
+
+/**
+ * @brief Compute task levels from the dependency spill file
+ *
+ * @param name_hashes: the per-task name hashes, in file order
+ * @param num_dependencies: the number of dependencies in the dependency spill file
+ *
+ * @throw std::invalid_argument
+ */
+void StreamingWorkflowReader::computeLevels(const std::vector<uint64_t> &name_hashes, unsigned long num_dependencies) {
+    const unsigned long n = name_hashes.size();
+
+    // Index tasks by name hash
+    std::vector<unsigned long> by_hash(n);
+    std::iota(by_hash.begin(), by_hash.end(), 0);
+    std::sort(by_hash.begin(), by_hash.end(), [&name_hashes](unsigned long a, unsigned long b) {
+        return name_hashes[a] < name_hashes[b];
+    });
+    for (unsigned long i = 1; i < n; i++) {
+        if (name_hashes[by_hash[i]] == name_hashes[by_hash[i - 1]]) {
+            throw std::invalid_argument("StreamingWorkflowReader: duplicate task names (or task name hash collision)");
+        }
+    }
+    auto find_task = [&name_hashes, &by_hash](uint64_t hash) -> long {
+        auto it = std::lower_bound(by_hash.begin(), by_hash.end(), hash, [&name_hashes](unsigned long t, uint64_t h) {
+            return name_hashes[t] < h;
+        });
+        return ((it == by_hash.end()) or (name_hashes[*it] != hash)) ? -1 : (long)*it;
+    };
+
+    // Children of each task (dependencies on unknown tasks are ignored, as in the in-memory parser), in two
+    // passes over the dependency stream
+    std::vector<unsigned long> child_offsets(n + 1, 0);
+    std::vector<unsigned long> num_pending_parents(n, 0);
+    struct dependency_record dependency{};
+    {
+        SpillFile dependencies(this->dependency_file_path, "rb");
+        while (dependencies.read(&dependency, sizeof(dependency))) {
+            long parent = find_task(dependency.parent_name_hash);
+            if (parent >= 0) {
+                child_offsets[parent + 1]++;
+                num_pending_parents[dependency.child]++;
+            }
+        }
+    }
+    for (unsigned long t = 0; t < n; t++) {
+        child_offsets[t + 1] += child_offsets[t];
+    }
+    std::vector<unsigned long> children(child_offsets[n]);
+    {
+        std::vector<unsigned long> next_child(child_offsets.begin(), child_offsets.end() - 1);
+        SpillFile dependencies(this->dependency_file_path, "rb");
+        while (dependencies.read(&dependency, sizeof(dependency))) {
+            long parent = find_task(dependency.parent_name_hash);
+            if (parent >= 0) {
+                children[next_child[parent]++] = dependency.child;
+            }
+        }
+    }
+    by_hash.clear();
+    by_hash.shrink_to_fit();
+
+    // Levels (longest path from an entry task), in topological order
+    this->levels.assign(n, 0);
+    std::vector<unsigned long> ready;
+    for (unsigned long t = 0; t < n; t++) {
+        if (num_pending_parents[t] == 0) {
+            ready.push_back(t);
+        }
+    }
+    unsigned long num_visited = 0;
+    while (not ready.empty()) {
+        unsigned long t = ready.back();
+        ready.pop_back();
+        num_visited++;
+        for (unsigned long c = child_offsets[t]; c < child_offsets[t + 1]; c++) {
+            unsigned long child = children[c];
+            this->levels[child] = std::max<unsigned long>(this->levels[child], this->levels[t] + 1);
+            if (--num_pending_parents[child] == 0) {
+                ready.push_back(child);
+            }
+        }
+    }
+    if (num_visited != n) {
+        throw std::invalid_argument("StreamingWorkflowReader: the workflow has a cycle");
+    }
+
+    for (auto level : this->levels) {
+        if (level >= this->level_widths.size()) {
+            this->level_widths.resize(level + 1, 0);
+        }
+        this->level_widths[level]++;
+    }
+    this->num_dependencies = num_dependencies;
+}
+
+/**
+ * Documentation in .h file
+ */
+void StreamingWorkflowReader::forEachLevel(const std::function<void(const WorkflowSummary &)> &callback) const {
+    const unsigned long num_levels = this->level_widths.size();
+    const unsigned long budget_tasks = this->memory_budget / (sizeof(struct task_record) + 64);
+
+    std::vector<struct task_record> records;
+    std::vector<std::string> names;
+    std::vector<unsigned long> order;
+    std::vector<unsigned long> chunk_offsets;
+
+    unsigned long first_level = 0;
+    while (first_level < num_levels) {
+        // Levels [first_level, last_level) are streamed back with one scan of the task spill file
+        unsigned long last_level = first_level + 1;
+        unsigned long num_chunk_tasks = this->level_widths[first_level];
+        while ((last_level < num_levels) and (num_chunk_tasks + this->level_widths[last_level] <= budget_tasks)) {
+            num_chunk_tasks += this->level_widths[last_level++];
+        }
+        chunk_offsets.assign(1, 0);
+        for (unsigned long l = first_level; l < last_level; l++) {
+            chunk_offsets.push_back(chunk_offsets.back() + this->level_widths[l]);
+        }
+        std::vector<unsigned long> next(chunk_offsets.begin(), chunk_offsets.end() - 1);
+        records.resize(num_chunk_tasks);
+        names.resize(num_chunk_tasks);
+
+        {
+            SpillFile tasks(this->task_file_path, "rb");
+            struct task_record record{};
+            std::string name;
+            for (unsigned long t = 0; tasks.read(&record, sizeof(record)); t++) {
+                name.resize(record.name_length);
+                if (not tasks.read(&name[0], record.name_length)) {
+                    throw std::invalid_argument("StreamingWorkflowReader: truncated spill file");
+                }
+                unsigned long level = this->levels[t];
+                if ((level >= first_level) and (level < last_level)) {
+                    unsigned long index = next[level - first_level]++;
+                    records[index] = record;
+                    names[index] = name;
+                }
+            }
+        }
+
+        // Tasks of a level are in task ID order, as wrench::Workflow::getTasks() returns them
+        for (unsigned long l = first_level; l < last_level; l++) {
+            const unsigned long first = chunk_offsets[l - first_level];
+            const unsigned long width = this->level_widths[l];
+            order.resize(width);
+            std::iota(order.begin(), order.end(), first);
+            std::sort(order.begin(), order.end(), [&names](unsigned long a, unsigned long b) {
+                return names[a] < names[b];
+            });
+
+            WorkflowSummary level_summary;
+            level_summary.num_tasks = width;
+            level_summary.max_level_width = width;
+            level_summary.max_task_cores = this->totals.max_task_cores;
+            level_summary.level_offsets = {0, width};
+            level_summary.work.assign(width, 1.0); // tasks are created with one unit of work, as in the in-memory parser
+            level_summary.intermediate_bytes_read.assign(width, 0.0);
+            level_summary.intermediate_bytes_written.assign(width, 0.0);
+            for (auto i : order) {
+                level_summary.bytes_read.push_back(records[i].bytes_read);
+                level_summary.bytes_written.push_back(records[i].bytes_written);
+                level_summary.num_cores.push_back(records[i].num_cores);
+                level_summary.category.push_back(records[i].category);
+            }
+            callback(level_summary);
+        }
+
+        first_level = last_level;
+    }
+}
@@ -0,0 +1,182 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <TransitiveReduction.h>
+
+// Minimum number of nodes in a level for the level to be processed in parallel
+#define PARALLEL_LEVEL_WIDTH 4096
+
+/**
+ * Documentation in .h file
+ */
+unsigned long TransitiveReduction::reduce(std::vector<std::vector<unsigned long>> &parents,
+                                          unsigned long num_threads,
+                                          unsigned long memory_budget) {
+    const unsigned long n = parents.size();
+    unsigned long num_removed = 0;
+
+    // Remove duplicate edges
+    for (auto &p : parents) {
+        std::sort(p.begin(), p.end());
+        auto last = std::unique(p.begin(), p.end());
+        num_removed += p.end() - last;
+        p.erase(last, p.end());
+    }
+
+    // Compute levels (longest path from an entry node) in topological order
+    std::vector<unsigned long> child_offsets(n + 1, 0);
+    for (auto const &p : parents) {
+        for (auto parent : p) {
+            child_offsets[parent + 1]++;
+        }
+    }
+    for (unsigned long v = 0; v < n; v++) {
+        child_offsets[v + 1] += child_offsets[v];
+    }
+    std::vector<unsigned long> children(child_offsets[n]);
+    std::vector<unsigned long> next_child(child_offsets.begin(), child_offsets.end() - 1);
+    for (unsigned long v = 0; v < n; v++) {
+        for (auto parent : parents[v]) {
+            children[next_child[parent]++] = v;
+        }
+    }
+    std::vector<unsigned long> level(n, 0);
+    std::vector<unsigned long> num_pending_parents(n);
+    std::vector<unsigned long> topological_order;
+    topological_order.reserve(n);
+    for (unsigned long v = 0; v < n; v++) {
+        num_pending_parents[v] = parents[v].size();
+        if (num_pending_parents[v] == 0) {
+            topological_order.push_back(v);
+        }
+    }
+    for (unsigned long i = 0; i < topological_order.size(); i++) {
+        unsigned long v = topological_order[i];
+        for (unsigned long c = child_offsets[v]; c < child_offsets[v + 1]; c++) {
+            unsigned long child = children[c];
+            level[child] = std::max<unsigned long>(level[child], level[v] + 1);
+            if (--num_pending_parents[child] == 0) {
+                topological_order.push_back(child);
+            }
+        }
+    }
+    if (topological_order.size() != n) {
+        throw std::invalid_argument("TransitiveReduction::reduce(): the graph has a cycle");
+    }
+
+    // Group nodes by level (topological order is not level order)
+    unsigned long num_levels = n == 0 ? 0 : *std::max_element(level.begin(), level.end()) + 1;
+    std::vector<unsigned long> level_offsets(num_levels + 1, 0);
+    for (unsigned long v = 0; v < n; v++) {
+        level_offsets[level[v] + 1]++;
+    }
+    for (unsigned long l = 0; l < num_levels; l++) {
+        level_offsets[l + 1] += level_offsets[l];
+    }
+    std::vector<unsigned long> nodes_by_level(n);
+    std::vector<unsigned long> next_node(level_offsets.begin(), level_offsets.end() - 1);
+    for (unsigned long v = 0; v < n; v++) {
+        nodes_by_level[next_node[level[v]]++] = v;
+    }
+
+    // Sources of candidate edges (those that skip levels) are given bitset columns
+    std::vector<long> column(n, -1);
+    unsigned long num_columns = 0;
+    for (unsigned long v = 0; v < n; v++) {
+        for (auto parent : parents[v]) {
+            if ((level[parent] + 1 < level[v]) and (column[parent] < 0)) {
+                column[parent] = (long)num_columns++;
+            }
+        }
+    }
+    if (num_columns == 0) {
+        return num_removed;
+    }
+
+    const unsigned long num_words = (num_columns + 63) / 64;
+    const unsigned long words_per_chunk = std::max<unsigned long>(1, std::min<unsigned long>(num_words, memory_budget / (8 * n)));
+    std::vector<std::vector<char>> redundant(n);
+    for (unsigned long v = 0; v < n; v++) {
+        redundant[v].resize(parents[v].size(), 0);
+    }
+    std::vector<uint64_t> ancestors;
+
+    for (unsigned long first_word = 0; first_word < num_words; first_word += words_per_chunk) {
+        const unsigned long w = std::min<unsigned long>(words_per_chunk, num_words - first_word);
+        const long first_column = (long)(first_word * 64);
+        const long last_column = (long)((first_word + w) * 64);
+        ancestors.assign(n * w, 0);
+
+        // Mark the candidate edges whose source is an ancestor of another parent, and compute the
+        // (candidate source) ancestors of the node
+        auto process = [&](unsigned long v) {
+            uint64_t *a = ancestors.data() + v * w;
+            for (auto parent : parents[v]) {
+                const uint64_t *pa = ancestors.data() + parent * w;
+                for (unsigned long i = 0; i < w; i++) {
+                    a[i] |= pa[i];
+                }
+            }
+            for (unsigned long i = 0; i < parents[v].size(); i++) {
+                long c = column[parents[v][i]];
+                if ((c >= first_column) and (c < last_column) and (level[parents[v][i]] + 1 < level[v])) {
+                    c -= first_column;
+                    redundant[v][i] = (a[c / 64] >> (c % 64)) & 1UL;
+                }
+            }
+            for (auto parent : parents[v]) {
+                long c = column[parent];
+                if ((c >= first_column) and (c < last_column)) {
+                    c -= first_column;
+                    a[c / 64] |= (1UL << (c % 64));
+                }
+            }
+        };
+
+        for (unsigned long l = 0; l < num_levels; l++) {
+            const unsigned long first = level_offsets[l];
+            const unsigned long width = level_offsets[l + 1] - first;
+            if ((num_threads <= 1) or (width < PARALLEL_LEVEL_WIDTH)) {
+                for (unsigned long i = first; i < first + width; i++) {
+                    process(nodes_by_level[i]);
+                }
+                continue;
+            }
+            std::vector<std::thread> workers;
+            for (unsigned long t = 0; t < num_threads; t++) {
+                workers.emplace_back([&, t]() {
+                    for (unsigned long i = first + t * width / num_threads; i < first + (t + 1) * width / num_threads; i++) {
+                        process(nodes_by_level[i]);
+                    }
+                });
+            }
+            for (auto &worker : workers) {
+                worker.join();
+            }
+        }
+    }
+
+    // Remove redundant edges
+    for (unsigned long v = 0; v < n; v++) {
+        unsigned long kept = 0;
+        for (unsigned long i = 0; i < parents[v].size(); i++) {
+            if (not redundant[v][i]) {
+                parents[v][kept++] = parents[v][i];
+            }
+        }
+        num_removed += parents[v].size() - kept;
+        parents[v].resize(kept);
+    }
+
+    return num_removed;
+}
@@ -10,70 +10,94 @@
 
 #include <stdexcept>
 #include <string>
-#include <unordered_map>
-#include <vector>
-#include <cerrno>
-#include <stdlib.h>
+#include <cctype>
+#include <cmath>
+#include <charconv>
 #include <UnitParser.h>
 
 
     /**
      * @brief Constructor
-     * @param generators: generators
+     * @param unit: the base unit
+     * @param value: the value of the base unit
+     * @param binary: true if binary prefixes (e.g., "Ki") are allowed, on top of decimal ones (e.g., "k")
      */
-    UnitParser::unit_scale::unit_scale(
-            std::initializer_list<std::tuple<const std::string, double, int, bool>> generators) {
-        for (const auto &gen : generators) {
-            const std::string &unit = std::get<0>(gen);
-            double value = std::get<1>(gen);
-            const int base = std::get<2>(gen);
-            const bool abbrev = std::get<3>(gen);
-            double mult;
-            std::vector<std::string> prefixes;
-            switch (base) {
-                case 2:
-                    mult = 1024.0;
-                    prefixes = abbrev ? std::vector<std::string>{"Ki", "Mi", "Gi", "Ti", "Pi", "Ei", "Zi", "Yi"}
-                                      : std::vector<std::string>{"kibi", "mebi", "gibi", "tebi", "pebi", "exbi", "zebi",
-                                                                 "yobi"};
-                    break;
-                case 10:
-                    mult = 1000.0;
-                    prefixes = abbrev ? std::vector<std::string>{"k", "M", "G", "T", "P", "E", "Z", "Y"}
-                                      : std::vector<std::string>{"kilo", "mega", "giga", "tera", "peta", "exa", "zeta",
-                                                                 "yotta"};
-                    break;
-                default:
-                    throw std::runtime_error("UnitParser::unit_scale::unit_scale(): The impossible has happened");
-            }
-            emplace(unit, value);
-            for (const auto &prefix : prefixes) {
-                value *= mult;
-                emplace(prefix + unit, value);
-            }
+    constexpr UnitParser::unit_scale::unit_scale(std::string_view unit, double value, bool binary) :
+            unit(unit), values{}, binary(binary) {
+        // Successive multiplications, so that values are exactly those of the original generators
+        values[0] = value;
+        for (int i = 1; i <= 8; i++) {
+            values[i] = values[i - 1] * 1000.0;
+            values[8 + i] = (i == 1 ? value : values[8 + i - 1]) * 1024.0;
         }
     }
 
-    double
-    UnitParser::parseValueWithUnit(std::string string, const UnitParser::unit_scale &units, const char *default_unit) {
-        char *ptr;
-        const char *c_string = string.c_str();
-        errno = 0;
+    /**
+     * @brief Find the index of a unit prefix in a unit_scale's values
+     * @param prefix: the prefix (e.g., "", "k", "Mi")
+     * @return an index, or -1 if the prefix is unknown
+     */
+    int UnitParser::prefixIndex(std::string_view prefix) {
+        static constexpr std::string_view decimal_letters = "kMGTPEZY";
+        static constexpr std::string_view binary_letters = "KMGTPEZY";
+        if (prefix.empty()) {
+            return 0;
+        }
+        if ((prefix.size() > 2) or ((prefix.size() == 2) and (prefix[1] != 'i'))) {
+            return -1;
+        }
+        auto position = (prefix.size() == 1 ? decimal_letters : binary_letters).find(prefix[0]);
+        if (position == std::string_view::npos) {
+            return -1;
+        }
+        return 1 + (int)position + (prefix.size() == 2 ? 8 : 0);
+    }
 
-        double res = strtod(c_string, &ptr);
-        if (errno == ERANGE)
-            throw std::runtime_error("Value out of range when parsing value " + string);
-        if (ptr == string)
-            throw std::runtime_error("Cannot parse value " + string);
-        if (ptr[0] == '\0') {
+    template <std::size_t N>
+    double UnitParser::parseValueWithUnit(std::string_view string, const std::array<unit_scale, N> &units, std::string_view default_unit) {
+        const char *first = string.data();
+        const char *last = string.data() + string.size();
+        // Accept what strtod() accepts before the number
+        while ((first != last) and isspace(*first)) {
+            first++;
+        }
+        if ((first != last) and (*first == '+') and ((last - first) == 1 or first[1] != '-')) {
+            first++;
+        }
+
+        double res;
+        std::from_chars_result parsed{first, std::errc::invalid_argument};
+        // Hexadecimal values (which strtod() accepts, but std::from_chars() does not expect a "0x" prefix for)
+        const char *digits = first + ((first != last) and (*first == '-') ? 1 : 0);
+        if ((last - digits > 2) and (digits[0] == '0') and ((digits[1] == 'x') or (digits[1] == 'X'))) {
+            parsed = std::from_chars(digits + 2, last, res, std::chars_format::hex);
+            if ((parsed.ec == std::errc()) and (digits != first)) {
+                res = -res;
+            }
+        }
+        if (parsed.ec == std::errc::invalid_argument) {
+            parsed = std::from_chars(first, last, res);
+        }
+        if ((parsed.ec == std::errc::result_out_of_range) or
+            ((parsed.ec == std::errc()) and (std::fpclassify(res) == FP_SUBNORMAL)))
+            throw std::runtime_error("Value out of range when parsing value " + std::string(string));
+        if (parsed.ec != std::errc())
+            throw std::runtime_error("Cannot parse value " + std::string(string));
+        std::string_view unit(parsed.ptr, last - parsed.ptr);
+        if (unit.empty()) {
             if (res == 0)
                 return res; // Ok, 0 can be unit-less
-            ptr = (char *) default_unit;
+            unit = default_unit;
+        }
+        for (const auto &u : units) {
+            if ((unit.size() >= u.unit.size()) and (unit.substr(unit.size() - u.unit.size()) == u.unit)) {
+                int index = prefixIndex(unit.substr(0, unit.size() - u.unit.size()));
+                if ((index >= 0) and ((index <= 8) or u.binary)) {
+                    return res * u.values[index];
+                }
+            }
         }
-        auto u = units.find(ptr);
-        if (u == units.end())
-            throw std::runtime_error("Unknown unit '" + std::string(ptr) + " when parsing value " + string);
-        return res * u->second;
+        throw std::runtime_error("Unknown unit '" + std::string(unit) + " when parsing value " + std::string(string));
     }
 
 
@@ -84,11 +108,9 @@
      *
      * @throws std::invalid_argument
      */
-    double UnitParser::parse_size(std::string string) {
-        static const UnitParser::unit_scale units{std::make_tuple("b", 0.125, 2, true),
-                                                  std::make_tuple("b", 0.125, 10, true),
-                                                  std::make_tuple("B", 1.0, 2, true),
-                                                  std::make_tuple("B", 1.0, 10, true)};
+    double UnitParser::parse_size(std::string_view string) {
+        static constexpr std::array<UnitParser::unit_scale, 2> units{UnitParser::unit_scale("b", 0.125, true),
+                                                                     UnitParser::unit_scale("B", 1.0, true)};
         double size;
         try {
             size = parseValueWithUnit(string, units, "B");  // default: bytes
@@ -106,8 +128,8 @@
      *
      * @throws std::invalid_argument
      */
-    double UnitParser::parse_compute_speed(std::string string) {
-        static const UnitParser::unit_scale units{std::make_tuple("f", 1.0, 10, true)};
+    double UnitParser::parse_compute_speed(std::string_view string) {
+        static constexpr std::array<UnitParser::unit_scale, 1> units{UnitParser::unit_scale("f", 1.0, false)};
         double compute_speed;
         try {
             compute_speed = parseValueWithUnit(string, units, "f");  // default: flop
@@ -124,10 +146,10 @@
      *
      * @throws std::invalid_argument
      */
-    double UnitParser::parse_bandwidth(std::string string)
+    double UnitParser::parse_bandwidth(std::string_view string)
     {
-        static const unit_scale units{std::make_tuple("bps", 0.125, 2, true), std::make_tuple("bps", 0.125, 10, true),
-                                      std::make_tuple("Bps", 1.0, 2, true), std::make_tuple("Bps", 1.0, 10, true)};
+        static constexpr std::array<UnitParser::unit_scale, 2> units{UnitParser::unit_scale("bps", 0.125, true),
+                                                                     UnitParser::unit_scale("Bps", 1.0, true)};
         double bandwidth;
         try {
             bandwidth = parseValueWithUnit(string, units, "Bps"); // default: Byte
@@ -136,4 +158,3 @@
         }
         return bandwidth;
     }
-
@@ -10,11 +10,14 @@
 #include <WfCommonsWorkflowParser.h>
 #include <wrench-dev.h>
 #include <UnitParser.h>
+#include <TransitiveReduction.h>
 #include <boost/algorithm/string.hpp>
 #include <sys/time.h>
 
 
 #include <iostream>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include <fstream>
 #include <nlohmann/json.hpp>
@@ -25,7 +28,11 @@
  */
 std::shared_ptr<wrench::Workflow> WfCommonsWorkflowParser::createWorkflowFromJSON(const std::string &filename,
                                                                                   double task_execution_time,
-                                                                                  bool redundant_dependencies) {
+                                                                                  bool redundant_dependencies,
+                                                                                  std::unordered_map<std::string, struct task_attributes> *task_attributes,
+                                                                                  WorkflowFingerprint *fingerprint,
+                                                                                  const std::string &file_id_prefix,
+                                                                                  unsigned long *num_removed_dependencies) {
 
     std::ifstream file;
     nlohmann::json j;
@@ -72,7 +79,56 @@ std::shared_ptr<wrench::Workflow> WfCommonsWorkflowParser::createWorkflowFromJSO
 
                 std::string name = job.at("name");
 
-                task = workflow->addTask(name, task_execution_time, 1, 1, 0.0);
+                if (fingerprint) {
+                    fingerprint->addTask(job);
+                }
+
+                // task cores ("cores", or "min_cores"/"max_cores" for moldable tasks)
+                unsigned long min_num_cores = 1;
+                unsigned long max_num_cores = 1;
+                if (job.contains("cores")) {
+                    min_num_cores = max_num_cores = job.at("cores").get<unsigned long>();
+                }
+                if (job.contains("min_cores")) {
+                    min_num_cores = job.at("min_cores").get<unsigned long>();
+                }
+                if (job.contains("max_cores")) {
+                    max_num_cores = job.at("max_cores").get<unsigned long>();
+                }
+                min_num_cores = std::max<unsigned long>(1, min_num_cores);
+                max_num_cores = std::max<unsigned long>(min_num_cores, max_num_cores);
+
+                task = workflow->addTask(name, task_execution_time, min_num_cores, max_num_cores, 0.0);
+
+                // task attributes (the category defaults to the name without its trailing ID)
+                if (task_attributes) {
+                    struct task_attributes attributes;
+                    if (job.contains("category")) {
+                        attributes.category = job.at("category").get<std::string>();
+                    } else {
+                        attributes.category = name.substr(0, name.find_last_of('_') == std::string::npos ? name.size() : name.find_last_of('_'));
+                    }
+                    // wfbench arguments are "--percent-cpu <value>", "--percent-cpu=<value>", or "--percent-cpu", "<value>"
+                    if (job.contains("command") and job.at("command").contains("arguments")) {
+                        std::vector<std::string> arguments = job.at("command").at("arguments");
+                        for (unsigned long i = 0; i < arguments.size(); i++) {
+                            if (not boost::algorithm::starts_with(arguments[i], "--percent-cpu")) {
+                                continue;
+                            }
+                            std::string value = arguments[i].substr(std::string("--percent-cpu").size());
+                            boost::algorithm::trim_if(value, boost::is_any_of(" ="));
+                            if (value.empty() and (i + 1 < arguments.size())) {
+                                value = arguments[i + 1];
+                            }
+                            try {
+                                attributes.percent_cpu = std::min<double>(1.0, std::max<double>(0.0, std::stod(value)));
+                            } catch (std::exception &e) {
+                                throw std::invalid_argument("Workflow::createWorkflowFromJson(): Invalid --percent-cpu argument for task " + name);
+                            }
+                        }
+                    }
+                    (*task_attributes)[name] = attributes;
+                }
 
                 // task files
                 std::vector<nlohmann::json> files = job.at("files");
@@ -80,7 +136,7 @@ std::shared_ptr<wrench::Workflow> WfCommonsWorkflowParser::createWorkflowFromJSO
                 for (auto &f : files) {
                     double size = f.at("size");
                     std::string link = f.at("link");
-                    std::string id = f.at("name");
+                    std::string id = file_id_prefix + f.at("name").get<std::string>();
                     std::shared_ptr<wrench::DataFile> workflow_file = nullptr;
                     // Add the file
                     try {
@@ -98,6 +154,8 @@ std::shared_ptr<wrench::Workflow> WfCommonsWorkflowParser::createWorkflowFromJSO
             }
 
             // since tasks may not be ordered in the JSON file, we need to iterate over all tasks again
+            std::vector<std::shared_ptr<wrench::WorkflowTask>> tasks;
+            std::unordered_map<std::string, unsigned long> task_indices;
             for (auto &job : jobs) {
                 try {
                     task = workflow->getTaskByID(job.at("name"));
@@ -105,17 +163,39 @@ std::shared_ptr<wrench::Workflow> WfCommonsWorkflowParser::createWorkflowFromJSO
                     // Ignored task
                     continue;
                 }
+                task_indices.emplace(task->getID(), tasks.size());
+                tasks.push_back(task);
+            }
+            std::vector<std::vector<unsigned long>> task_parents(tasks.size());
+            for (auto &job : jobs) {
+                auto it = task_indices.find(job.at("name").get<std::string>());
+                if (it == task_indices.end()) {
+                    continue;
+                }
                 std::vector<nlohmann::json> parents = job.at("parents");
-                // task dependencies
                 for (auto &parent : parents) {
-                    try {
-                        auto parent_task = workflow->getTaskByID(parent);
-                        workflow->addControlDependency(parent_task, task, redundant_dependencies);
-                    } catch (std::invalid_argument &e) {
-                        // do nothing
+                    auto parent_it = task_indices.find(parent.get<std::string>());
+                    if (parent_it != task_indices.end()) {
+                        task_parents[it->second].push_back(parent_it->second);
                     }
                 }
             }
+
+            // remove redundant dependencies up front, so that WRENCH does not have to check them
+            unsigned long num_removed = 0;
+            if (not redundant_dependencies) {
+                num_removed = TransitiveReduction::reduce(task_parents, std::thread::hardware_concurrency());
+            }
+            if (num_removed_dependencies) {
+                *num_removed_dependencies = num_removed;
+            }
+
+            // task dependencies
+            for (unsigned long t = 0; t < tasks.size(); t++) {
+                for (auto parent : task_parents[t]) {
+                    workflow->addControlDependency(tasks[parent], tasks[t], true);
+                }
+            }
         }
     }
     file.close();
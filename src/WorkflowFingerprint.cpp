@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <cstdio>
+#include <nlohmann/json.hpp>
+#include <WorkflowFingerprint.h>
+
+/**
+ * Documentation in .h file
+ */
+uint64_t WorkflowFingerprint::hash(const std::string &bytes, uint64_t seed) {
+    // FNV-1a, with a seeded offset basis and a final avalanche (splitmix64)
+    uint64_t h = 0xcbf29ce484222325ULL ^ (seed * 0x9e3779b97f4a7c15ULL);
+    for (unsigned char c : bytes) {
+        h = (h ^ c) * 0x100000001b3ULL;
+    }
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+}
+
+/**
+ * Documentation in .h file
+ */
+void WorkflowFingerprint::addTask(const nlohmann::json &job) {
+    // Fields are separated by a byte that JSON strings cannot hold unescaped
+    std::string bytes = job.at("name").get<std::string>();
+    for (auto const &field : {"category", "cores", "min_cores", "max_cores", "command"}) {
+        bytes += '\x01';
+        if (job.contains(field)) {
+            bytes += job.at(field).dump();
+        }
+    }
+    for (auto const &f : job.at("files")) {
+        bytes += '\x02' + f.at("name").get<std::string>() + '\x01' + f.at("link").get<std::string>() +
+                 '\x01' + f.at("size").dump();
+    }
+    for (auto const &parent : job.at("parents")) {
+        bytes += '\x03' + parent.get<std::string>();
+    }
+    this->low += hash(bytes, 1);
+    this->high += hash(bytes, 2);
+}
+
+/**
+ * Documentation in .h file
+ */
+std::string WorkflowFingerprint::toString() const {
+    char digits[33];
+    snprintf(digits, sizeof(digits), "%016llx%016llx", (unsigned long long)this->high, (unsigned long long)this->low);
+    return {digits};
+}
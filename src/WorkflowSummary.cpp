@@ -0,0 +1,609 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+#include <wrench-dev.h>
+#include <WorkflowSummary.h>
+
+/**
+ * Documentation in .h file
+ */
+WorkflowSummary WorkflowSummary::createFromWorkflow(const std::shared_ptr<wrench::Workflow> &workflow,
+                                                    const std::unordered_map<std::string, struct task_attributes> *attributes,
+                                                    const std::unordered_map<std::string, double> *category_overlaps) {
+    WorkflowSummary summary;
+
+    auto tasks = workflow->getTasks();
+    summary.num_tasks = tasks.size();
+    unsigned long num_levels = workflow->getNumLevels();
+
+    // Counting sort of the tasks by top level
+    std::vector<unsigned long> level_counts(num_levels + 1, 0);
+    for (auto const &t : tasks) {
+        level_counts[t->getTopLevel() + 1]++;
+    }
+    for (unsigned long l = 0; l < num_levels; l++) {
+        summary.max_level_width = std::max<unsigned long>(summary.max_level_width, level_counts[l + 1]);
+        level_counts[l + 1] += level_counts[l];
+    }
+    summary.level_offsets = level_counts;
+
+    summary.work.resize(tasks.size());
+    summary.bytes_read.resize(tasks.size());
+    summary.bytes_written.resize(tasks.size());
+    summary.num_cores.resize(tasks.size(), 1);
+    summary.category.resize(tasks.size(), 0);
+    if (category_overlaps) {
+        summary.overlap.resize(tasks.size(), 0.0);
+    }
+    summary.categories.emplace_back("");
+    std::unordered_map<std::string, unsigned long> category_indices = {{"", 0}};
+    std::vector<unsigned long> next = level_counts;
+    std::vector<std::shared_ptr<wrench::WorkflowTask>> tasks_by_index(tasks.size());
+    for (auto const &t : tasks) {
+        unsigned long index = next[t->getTopLevel()]++;
+        tasks_by_index[index] = t;
+        double read = 0.0;
+        for (auto const &f : t->getInputFiles()) {
+            read += f->getSize();
+        }
+        double written = 0.0;
+        for (auto const &f : t->getOutputFiles()) {
+            written += f->getSize();
+        }
+        summary.work[index] = t->getFlops();
+        summary.bytes_read[index] = read;
+        summary.bytes_written[index] = written;
+        summary.num_cores[index] = std::max<unsigned long>(1, t->getMinNumCores());
+        summary.max_task_cores = std::max<unsigned long>(summary.max_task_cores, summary.num_cores[index]);
+        double percent_cpu = 1.0;
+        if (attributes) {
+            auto it = attributes->find(t->getID());
+            if (it != attributes->end()) {
+                auto category = category_indices.emplace(it->second.category, summary.categories.size());
+                if (category.second) {
+                    summary.categories.push_back(it->second.category);
+                }
+                summary.category[index] = category.first->second;
+                percent_cpu = it->second.percent_cpu;
+            }
+        }
+        // The overlap is precomputed once, so that estimates do not look up categories
+        if (category_overlaps) {
+            auto factor = category_overlaps->find(summary.categories[summary.category[index]]);
+            if (factor == category_overlaps->end()) {
+                factor = category_overlaps->find("*");
+            }
+            if (factor != category_overlaps->end()) {
+                summary.overlap[index] = factor->second * percent_cpu;
+            }
+        }
+    }
+
+    // Totals are summed in level order, so that they do not depend on how tasks are stored (see StreamingWorkflowReader)
+    for (unsigned long t = 0; t < tasks.size(); t++) {
+        summary.total_work += summary.work[t];
+        summary.total_bytes_read += summary.bytes_read[t];
+        summary.total_bytes_written += summary.bytes_written[t];
+    }
+
+    // Index task parents
+    std::unordered_map<const wrench::WorkflowTask *, unsigned long> task_indices;
+    for (unsigned long t = 0; t < tasks.size(); t++) {
+        task_indices[tasks_by_index[t].get()] = t;
+    }
+    summary.parent_offsets.push_back(0);
+    for (unsigned long t = 0; t < tasks.size(); t++) {
+        for (auto const &parent : tasks_by_index[t]->getParents()) {
+            summary.parents.push_back(task_indices[parent.get()]);
+        }
+        summary.parent_offsets.push_back(summary.parents.size());
+    }
+
+    // Index files, with their producers
+    std::unordered_map<std::string, unsigned long> file_indices;
+    auto file_index = [&summary, &file_indices](const std::shared_ptr<wrench::DataFile> &f) {
+        auto file = file_indices.emplace(f->getID(), summary.file_sizes.size());
+        if (file.second) {
+            summary.file_sizes.push_back(f->getSize());
+            summary.file_producers.push_back(-1);
+        }
+        return file.first->second;
+    };
+    std::vector<std::vector<unsigned long>> task_inputs(tasks.size());
+    std::vector<std::vector<unsigned long>> task_outputs(tasks.size());
+    for (unsigned long t = 0; t < tasks.size(); t++) {
+        for (auto const &f : tasks_by_index[t]->getInputFiles()) {
+            task_inputs[t].push_back(file_index(f));
+        }
+        for (auto const &f : tasks_by_index[t]->getOutputFiles()) {
+            task_outputs[t].push_back(file_index(f));
+            summary.file_producers[task_outputs[t].back()] = (long)t;
+        }
+    }
+
+    // Bytes read from/written to intermediate files
+    std::vector<char> consumed(summary.file_sizes.size(), 0);
+    for (auto const &inputs : task_inputs) {
+        for (auto f : inputs) {
+            consumed[f] = 1;
+        }
+    }
+    summary.intermediate_bytes_read.resize(tasks.size(), 0.0);
+    summary.intermediate_bytes_written.resize(tasks.size(), 0.0);
+    for (unsigned long t = 0; t < tasks.size(); t++) {
+        for (auto f : task_inputs[t]) {
+            if (summary.file_producers[f] >= 0) {
+                summary.intermediate_bytes_read[t] += summary.file_sizes[f];
+            }
+        }
+        for (auto f : task_outputs[t]) {
+            if (consumed[f]) {
+                summary.intermediate_bytes_written[t] += summary.file_sizes[f];
+            }
+        }
+    }
+
+    // Index data dependencies: the bytes that each task reads from each of its producers
+    std::vector<long> producer_edges(tasks.size(), -1);
+    summary.producer_offsets.push_back(0);
+    for (unsigned long t = 0; t < tasks.size(); t++) {
+        for (auto f : task_inputs[t]) {
+            long producer = summary.file_producers[f];
+            if (producer < 0) {
+                continue;
+            }
+            if (producer_edges[producer] < 0) {
+                producer_edges[producer] = (long)summary.producers.size();
+                summary.producers.push_back(producer);
+                summary.producer_bytes.push_back(0.0);
+            }
+            summary.producer_bytes[producer_edges[producer]] += summary.file_sizes[f];
+        }
+        for (unsigned long i = summary.producer_offsets[t]; i < summary.producers.size(); i++) {
+            producer_edges[summary.producers[i]] = -1;
+        }
+        summary.producer_offsets.push_back(summary.producers.size());
+    }
+
+    // Index input files that are read by several tasks of a same level
+    std::vector<unsigned long> num_consumers(summary.file_sizes.size(), 0);
+    summary.shared_input_offsets.push_back(0);
+    for (unsigned long l = 0; l < num_levels; l++) {
+        for (unsigned long t = summary.level_offsets[l]; t < summary.level_offsets[l + 1]; t++) {
+            for (auto f : task_inputs[t]) {
+                num_consumers[f]++;
+            }
+        }
+        for (unsigned long t = summary.level_offsets[l]; t < summary.level_offsets[l + 1]; t++) {
+            for (auto f : task_inputs[t]) {
+                if (num_consumers[f] > 1) {
+                    summary.shared_inputs.push_back(f);
+                    summary.shared_input_consumers.push_back(num_consumers[f]);
+                }
+            }
+            summary.shared_input_offsets.push_back(summary.shared_inputs.size());
+        }
+        for (unsigned long t = summary.level_offsets[l]; t < summary.level_offsets[l + 1]; t++) {
+            for (auto f : task_inputs[t]) {
+                num_consumers[f] = 0;
+            }
+        }
+    }
+
+    return summary;
+}
+
+/**
+ * Documentation in .h file
+ */
+WorkflowSummary WorkflowSummary::createGrouped(const WorkflowSummary &summary) {
+    if (summary.isGrouped()) {
+        return summary;
+    }
+
+    WorkflowSummary grouped;
+    grouped.num_tasks = summary.num_tasks;
+    grouped.categories = summary.categories;
+    grouped.max_task_cores = summary.max_task_cores;
+    grouped.total_work = summary.total_work;
+    grouped.total_bytes_read = summary.total_bytes_read;
+    grouped.total_bytes_written = summary.total_bytes_written;
+    grouped.level_offsets.push_back(0);
+
+    // Group the tasks of each level by signature, groups being in the order of their first task
+    typedef std::tuple<unsigned long, double, double, double, double, double, unsigned long, double> signature;
+    auto hash = [](const signature &key) {
+        size_t h = std::hash<unsigned long>()(std::get<0>(key));
+        h = h * 31 + std::hash<double>()(std::get<1>(key));
+        h = h * 31 + std::hash<double>()(std::get<2>(key));
+        h = h * 31 + std::hash<double>()(std::get<3>(key));
+        h = h * 31 + std::hash<double>()(std::get<4>(key));
+        h = h * 31 + std::hash<double>()(std::get<5>(key));
+        h = h * 31 + std::hash<unsigned long>()(std::get<6>(key));
+        return h * 31 + std::hash<double>()(std::get<7>(key));
+    };
+    std::unordered_map<signature, unsigned long, decltype(hash)> groups(16, hash);
+    for (unsigned long l = 0; l < summary.getNumLevels(); l++) {
+        groups.clear();
+        for (unsigned long t = summary.level_offsets[l]; t < summary.level_offsets[l + 1]; t++) {
+            auto group = groups.emplace(std::make_tuple(summary.category[t], summary.work[t],
+                                                        summary.bytes_read[t], summary.bytes_written[t],
+                                                        summary.intermediate_bytes_read[t],
+                                                        summary.intermediate_bytes_written[t],
+                                                        summary.num_cores[t],
+                                                        summary.hasOverlap() ? summary.overlap[t] : 0.0),
+                                        grouped.work.size());
+            if (not group.second) {
+                grouped.multiplicity[group.first->second]++;
+                continue;
+            }
+            grouped.work.push_back(summary.work[t]);
+            grouped.bytes_read.push_back(summary.bytes_read[t]);
+            grouped.bytes_written.push_back(summary.bytes_written[t]);
+            grouped.intermediate_bytes_read.push_back(summary.intermediate_bytes_read[t]);
+            grouped.intermediate_bytes_written.push_back(summary.intermediate_bytes_written[t]);
+            grouped.num_cores.push_back(summary.num_cores[t]);
+            grouped.category.push_back(summary.category[t]);
+            if (summary.hasOverlap()) {
+                grouped.overlap.push_back(summary.overlap[t]);
+            }
+            grouped.multiplicity.push_back(1);
+        }
+        grouped.level_offsets.push_back(grouped.work.size());
+        grouped.max_level_width = std::max<unsigned long>(grouped.max_level_width, grouped.getLevelWidth(l));
+    }
+
+    return grouped;
+}
+
+/**
+ * Documentation in .h file
+ */
+WorkflowSummary WorkflowSummary::createWithPageCache(const WorkflowSummary &summary,
+                                                     unsigned long num_nodes,
+                                                     double page_cache_size) {
+    if (summary.isGrouped()) {
+        throw std::invalid_argument("WorkflowSummary::createWithPageCache(): grouped summaries have no file information");
+    }
+
+    WorkflowSummary cached = summary;
+    if ((page_cache_size <= 0) or summary.shared_inputs.empty()) {
+        return cached;
+    }
+
+    // Per-file level in which the file was last seen/cached
+    std::vector<long> seen(summary.file_sizes.size(), -1);
+    std::vector<long> in_cache(summary.file_sizes.size(), -1);
+    std::vector<std::pair<unsigned long, unsigned long>> candidates;
+    auto num_reads = [num_nodes](unsigned long num_consumers) {
+        return std::min<unsigned long>(num_consumers, num_nodes);
+    };
+
+    cached.total_bytes_read = 0.0;
+    for (unsigned long l = 0; l < summary.getNumLevels(); l++) {
+        const unsigned long first = summary.level_offsets[l];
+        const unsigned long last = summary.level_offsets[l + 1];
+
+        // Shared input files of the level that caching would save reads of
+        candidates.clear();
+        for (unsigned long i = summary.shared_input_offsets[first]; i < summary.shared_input_offsets[last]; i++) {
+            unsigned long f = summary.shared_inputs[i];
+            if ((seen[f] != (long)l) and (num_reads(summary.shared_input_consumers[i]) < summary.shared_input_consumers[i])) {
+                seen[f] = (long)l;
+                candidates.emplace_back(f, summary.shared_input_consumers[i]);
+            }
+        }
+
+        // Cache files by decreasing number of saved reads per byte, i.e., per unit of file size
+        std::sort(candidates.begin(), candidates.end(), [&summary, &num_reads](const std::pair<unsigned long, unsigned long> &a,
+                                                                               const std::pair<unsigned long, unsigned long> &b) {
+            unsigned long saved_a = a.second - num_reads(a.second);
+            unsigned long saved_b = b.second - num_reads(b.second);
+            double size_a = summary.file_sizes[a.first];
+            double size_b = summary.file_sizes[b.first];
+            return (saved_a > saved_b) or ((saved_a == saved_b) and ((size_a < size_b) or ((size_a == size_b) and (a.first < b.first))));
+        });
+        double used = 0.0;
+        for (auto const &c : candidates) {
+            if (used + summary.file_sizes[c.first] <= page_cache_size) {
+                used += summary.file_sizes[c.first];
+                in_cache[c.first] = (long)l;
+            }
+        }
+
+        // Each task is charged its share of the file system reads of cached files
+        for (unsigned long t = first; t < last; t++) {
+            for (unsigned long i = summary.shared_input_offsets[t]; i < summary.shared_input_offsets[t + 1]; i++) {
+                unsigned long f = summary.shared_inputs[i];
+                if (in_cache[f] == (long)l) {
+                    unsigned long c = summary.shared_input_consumers[i];
+                    double saved = summary.file_sizes[f] * (1.0 - (double)num_reads(c) / (double)c);
+                    cached.bytes_read[t] -= saved;
+                    if (summary.file_producers[f] >= 0) {
+                        cached.intermediate_bytes_read[t] -= saved;
+                    }
+                }
+            }
+            cached.bytes_read[t] = std::max<double>(0.0, cached.bytes_read[t]);
+            cached.intermediate_bytes_read[t] = std::max<double>(0.0, cached.intermediate_bytes_read[t]);
+            cached.total_bytes_read += cached.bytes_read[t];
+        }
+    }
+
+    return cached;
+}
+
+/**
+ * Documentation in .h file
+ */
+WorkflowSummary WorkflowSummary::createWithStaging(const WorkflowSummary &summary,
+                                                   const struct platform_config &config) {
+    WorkflowSummary staged = summary;
+    if ((config.local_read_speed_per_node <= 0) or (config.local_write_speed_per_node <= 0)) {
+        return staged;
+    }
+
+    // Intermediate bytes are converted to the number of file system bytes that take as long to transfer
+    const double read_ratio = config.io_read_speed_per_node / config.local_read_speed_per_node;
+    const double write_ratio = config.io_write_speed_per_node / config.local_write_speed_per_node;
+    staged.total_bytes_read = 0.0;
+    staged.total_bytes_written = 0.0;
+    for (unsigned long t = 0; t < staged.work.size(); t++) {
+        staged.bytes_read[t] += summary.intermediate_bytes_read[t] * (read_ratio - 1.0);
+        staged.bytes_written[t] += summary.intermediate_bytes_written[t] * (write_ratio - 1.0);
+        staged.intermediate_bytes_read[t] = 0.0;
+        staged.intermediate_bytes_written[t] = 0.0;
+        double multiplicity = staged.isGrouped() ? (double)staged.multiplicity[t] : 1.0;
+        staged.total_bytes_read += multiplicity * staged.bytes_read[t];
+        staged.total_bytes_written += multiplicity * staged.bytes_written[t];
+    }
+    return staged;
+}
+
+/**
+ * @brief Check that the per-task arrays and the dependencies of a (non-grouped) summary are complete, and that
+ *        their indices are in range, as the summaries derived from it index them without checks
+ *
+ * @param summary: the workflow summary
+ * @param caller: the name of the calling function (for error messages)
+ *
+ * @throw std::invalid_argument
+ */
+static void check_dependencies(const WorkflowSummary &summary, const std::string &caller) {
+    const unsigned long n = summary.work.size();
+    auto invalid = [&caller](const std::string &what) {
+        return std::invalid_argument(caller + "(): " + what);
+    };
+    // Offsets of per-task lists: n + 1 non-decreasing offsets, from 0 to the list's size
+    auto check_offsets = [&](const std::vector<unsigned long> &offsets, unsigned long size, const std::string &name) {
+        if ((offsets.size() != n + 1) or (offsets.front() != 0) or (offsets.back() != size) or
+            (not std::is_sorted(offsets.begin(), offsets.end()))) {
+            throw invalid("the summary has no valid " + name);
+        }
+    };
+
+    if ((summary.bytes_read.size() != n) or (summary.bytes_written.size() != n) or
+        (summary.intermediate_bytes_read.size() != n) or (summary.intermediate_bytes_written.size() != n) or
+        (summary.num_cores.size() != n) or (summary.category.size() != n) or
+        ((not summary.overlap.empty()) and (summary.overlap.size() != n))) {
+        throw invalid("the summary's per-task arrays do not all have one entry per task");
+    }
+    if (summary.level_offsets.empty() or (summary.level_offsets.front() != 0) or (summary.level_offsets.back() != n) or
+        (not std::is_sorted(summary.level_offsets.begin(), summary.level_offsets.end()))) {
+        throw invalid("the summary has no valid levels");
+    }
+    check_offsets(summary.shared_input_offsets, summary.shared_inputs.size(), "shared inputs");
+    check_offsets(summary.parent_offsets, summary.parents.size(), "control dependencies");
+    check_offsets(summary.producer_offsets, summary.producers.size(), "data dependencies");
+    if ((summary.shared_input_consumers.size() != summary.shared_inputs.size()) or
+        (summary.producer_bytes.size() != summary.producers.size()) or
+        (summary.file_producers.size() != summary.file_sizes.size())) {
+        throw invalid("the summary's dependencies are incomplete");
+    }
+    auto out_of_range = [](const std::vector<unsigned long> &indices, unsigned long size) {
+        return std::any_of(indices.begin(), indices.end(), [size](unsigned long i) { return i >= size; });
+    };
+    if (out_of_range(summary.shared_inputs, summary.file_sizes.size()) or out_of_range(summary.parents, n) or
+        out_of_range(summary.producers, n) or
+        std::any_of(summary.file_producers.begin(), summary.file_producers.end(),
+                    [n](long t) { return (t >= 0) and ((unsigned long)t >= n); })) {
+        throw invalid("the summary has out-of-range task or file indices");
+    }
+}
+
+/**
+ * Documentation in .h file
+ */
+WorkflowSummary WorkflowSummary::createUnion(const std::vector<WorkflowSummary> &summaries) {
+    WorkflowSummary ensemble;
+    ensemble.num_members = summaries.size();
+    unsigned long num_levels = 0;
+    bool overlap = false;
+    for (auto const &summary : summaries) {
+        if (summary.isGrouped() or summary.isEnsemble()) {
+            throw std::invalid_argument("WorkflowSummary::createUnion(): summaries cannot be grouped or ensembles");
+        }
+        check_dependencies(summary, "WorkflowSummary::createUnion");
+        if (std::any_of(summary.category.begin(), summary.category.end(),
+                        [&summary](unsigned long c) { return c >= summary.categories.size(); })) {
+            throw std::invalid_argument("WorkflowSummary::createUnion(): summaries must have task categories");
+        }
+        num_levels = std::max<unsigned long>(num_levels, summary.getNumLevels());
+        overlap = overlap or summary.hasOverlap();
+    }
+
+    // Categories are merged by name, and files are those of all workflows, in workflow order
+    std::unordered_map<std::string, unsigned long> category_indices;
+    std::vector<std::vector<unsigned long>> categories(summaries.size());
+    std::vector<unsigned long> file_offsets(summaries.size(), 0);
+    for (unsigned long m = 0; m < summaries.size(); m++) {
+        for (auto const &name : summaries[m].categories) {
+            auto category = category_indices.emplace(name, ensemble.categories.size());
+            if (category.second) {
+                ensemble.categories.push_back(name);
+            }
+            categories[m].push_back(category.first->second);
+        }
+        file_offsets[m] = ensemble.file_sizes.size();
+        ensemble.file_sizes.insert(ensemble.file_sizes.end(), summaries[m].file_sizes.begin(), summaries[m].file_sizes.end());
+        ensemble.num_tasks += summaries[m].num_tasks;
+        ensemble.total_work += summaries[m].total_work;
+        ensemble.total_bytes_read += summaries[m].total_bytes_read;
+        ensemble.total_bytes_written += summaries[m].total_bytes_written;
+        ensemble.max_task_cores = std::max<unsigned long>(ensemble.max_task_cores, summaries[m].max_task_cores);
+    }
+
+    // Tasks, level by level (indices maps the tasks of each workflow to ensemble tasks)
+    std::vector<std::vector<unsigned long>> indices(summaries.size());
+    std::vector<std::pair<unsigned long, unsigned long>> origins;
+    for (unsigned long m = 0; m < summaries.size(); m++) {
+        indices[m].resize(summaries[m].work.size());
+    }
+    ensemble.level_offsets.push_back(0);
+    ensemble.shared_input_offsets.push_back(0);
+    for (unsigned long l = 0; l < num_levels; l++) {
+        for (unsigned long m = 0; m < summaries.size(); m++) {
+            auto const &summary = summaries[m];
+            if (l >= summary.getNumLevels()) {
+                continue;
+            }
+            for (unsigned long t = summary.level_offsets[l]; t < summary.level_offsets[l + 1]; t++) {
+                indices[m][t] = ensemble.work.size();
+                origins.emplace_back(m, t);
+                ensemble.work.push_back(summary.work[t]);
+                ensemble.bytes_read.push_back(summary.bytes_read[t]);
+                ensemble.bytes_written.push_back(summary.bytes_written[t]);
+                ensemble.intermediate_bytes_read.push_back(summary.intermediate_bytes_read[t]);
+                ensemble.intermediate_bytes_written.push_back(summary.intermediate_bytes_written[t]);
+                ensemble.num_cores.push_back(summary.num_cores[t]);
+                ensemble.category.push_back(categories[m][summary.category[t]]);
+                if (overlap) {
+                    ensemble.overlap.push_back(summary.hasOverlap() ? summary.overlap[t] : 0.0);
+                }
+                ensemble.member.push_back(m);
+                for (unsigned long i = summary.shared_input_offsets[t]; i < summary.shared_input_offsets[t + 1]; i++) {
+                    ensemble.shared_inputs.push_back(file_offsets[m] + summary.shared_inputs[i]);
+                    ensemble.shared_input_consumers.push_back(summary.shared_input_consumers[i]);
+                }
+                ensemble.shared_input_offsets.push_back(ensemble.shared_inputs.size());
+            }
+        }
+        ensemble.level_offsets.push_back(ensemble.work.size());
+        ensemble.max_level_width = std::max<unsigned long>(ensemble.max_level_width, ensemble.getLevelWidth(l));
+    }
+
+    // Dependencies (control and data) and file producers, with ensemble task indices
+    ensemble.parent_offsets.push_back(0);
+    ensemble.producer_offsets.push_back(0);
+    for (auto const &origin : origins) {
+        auto const &summary = summaries[origin.first];
+        for (unsigned long i = summary.parent_offsets[origin.second]; i < summary.parent_offsets[origin.second + 1]; i++) {
+            ensemble.parents.push_back(indices[origin.first][summary.parents[i]]);
+        }
+        ensemble.parent_offsets.push_back(ensemble.parents.size());
+        for (unsigned long i = summary.producer_offsets[origin.second]; i < summary.producer_offsets[origin.second + 1]; i++) {
+            ensemble.producers.push_back(indices[origin.first][summary.producers[i]]);
+            ensemble.producer_bytes.push_back(summary.producer_bytes[i]);
+        }
+        ensemble.producer_offsets.push_back(ensemble.producers.size());
+    }
+    for (unsigned long m = 0; m < summaries.size(); m++) {
+        for (auto producer : summaries[m].file_producers) {
+            ensemble.file_producers.push_back(producer < 0 ? -1 : (long)indices[m][producer]);
+        }
+    }
+
+    return ensemble;
+}
+
+/**
+ * Documentation in .h file
+ */
+WorkflowSummary WorkflowSummary::createWithNetwork(const WorkflowSummary &summary,
+                                                   const struct platform_config &config) {
+    if (summary.isGrouped()) {
+        throw std::invalid_argument("WorkflowSummary::createWithNetwork(): grouped summaries have no dependencies");
+    }
+    check_dependencies(summary, "WorkflowSummary::createWithNetwork");
+    if (config.num_nodes == 0) {
+        throw std::invalid_argument("WorkflowSummary::createWithNetwork(): the number of nodes should be > 0");
+    }
+    WorkflowSummary placed = summary;
+    if (config.network_bandwidth_per_node <= 0) {
+        return placed;
+    }
+
+    // Transfers share the bisection bandwidth, and intermediate files are converted to the number of file
+    // system bytes that take as long to read/write (locally, and over the network, with one latency per edge)
+    const double network_bandwidth = config.bisection_bandwidth > 0 ?
+                                     std::min<double>(config.network_bandwidth_per_node,
+                                                      config.bisection_bandwidth / (double)config.num_nodes) :
+                                     config.network_bandwidth_per_node;
+    const bool local_storage = (config.local_read_speed_per_node > 0) and (config.local_write_speed_per_node > 0);
+    const double local_read_ratio = local_storage ? config.io_read_speed_per_node / config.local_read_speed_per_node : 1.0;
+    const double local_write_ratio = local_storage ? config.io_write_speed_per_node / config.local_write_speed_per_node : 1.0;
+    const double network_ratio = config.io_read_speed_per_node / network_bandwidth;
+    const double latency_bytes = config.network_latency * config.io_read_speed_per_node;
+
+    // Place the tasks of each level (at most ceil(width / num_nodes) per node) on the node of the producer they
+    // read the most bytes from, or else on the first node that is not full
+    std::vector<unsigned long> nodes(summary.work.size(), 0);
+    std::vector<unsigned long> loads(config.num_nodes);
+    for (unsigned long l = 0; l < summary.getNumLevels(); l++) {
+        const unsigned long capacity = (summary.getLevelWidth(l) + config.num_nodes - 1) / config.num_nodes;
+        std::fill(loads.begin(), loads.end(), 0);
+        unsigned long next_node = 0;
+        for (unsigned long t = summary.level_offsets[l]; t < summary.level_offsets[l + 1]; t++) {
+            long node = -1;
+            double max_bytes = 0.0;
+            for (unsigned long i = summary.producer_offsets[t]; i < summary.producer_offsets[t + 1]; i++) {
+                if (summary.producer_bytes[i] > max_bytes) {
+                    max_bytes = summary.producer_bytes[i];
+                    node = (long)nodes[summary.producers[i]];
+                }
+            }
+            if ((node < 0) or (loads[node] >= capacity)) {
+                while (loads[next_node] >= capacity) {
+                    next_node++;
+                }
+                node = (long)next_node;
+            }
+            nodes[t] = node;
+            loads[node]++;
+        }
+    }
+
+    placed.total_bytes_read = 0.0;
+    placed.total_bytes_written = 0.0;
+    for (unsigned long t = 0; t < placed.work.size(); t++) {
+        double local_bytes = 0.0;
+        double remote_bytes = 0.0;
+        unsigned long num_remote_edges = 0;
+        for (unsigned long i = summary.producer_offsets[t]; i < summary.producer_offsets[t + 1]; i++) {
+            if (nodes[summary.producers[i]] == nodes[t]) {
+                local_bytes += summary.producer_bytes[i];
+            } else {
+                remote_bytes += summary.producer_bytes[i];
+                num_remote_edges++;
+            }
+        }
+        placed.bytes_read[t] = std::max<double>(0.0, summary.bytes_read[t] - local_bytes - remote_bytes) +
+                               local_bytes * local_read_ratio + remote_bytes * network_ratio +
+                               (double)num_remote_edges * latency_bytes;
+        placed.bytes_written[t] += summary.intermediate_bytes_written[t] * (local_write_ratio - 1.0);
+        placed.intermediate_bytes_read[t] = 0.0;
+        placed.intermediate_bytes_written[t] = 0.0;
+        placed.total_bytes_read += placed.bytes_read[t];
+        placed.total_bytes_written += placed.bytes_written[t];
+    }
+    return placed;
+}
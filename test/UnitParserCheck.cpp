@@ -0,0 +1,192 @@
+/**
+ * Copyright (c) 2017-2022. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+/**
+ * Equivalence check of UnitParser against its previous (hash map based) implementation, on fixed and random
+ * value/unit strings: both parsers must return the same values, or throw the same errors. With the
+ * "benchmark" argument, both parsers are also timed on typical platform specification values.
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <UnitParser.h>
+
+/**
+ * @brief The previous implementation of UnitParser (unit tables built in hash maps, and std::string arguments)
+ */
+class LegacyUnitParser {
+
+    class unit_scale : public std::unordered_map<std::string, double> {
+    public:
+        // tuples are : <unit, value for unit, base (2 or 10)>
+        explicit unit_scale(std::initializer_list<std::tuple<const std::string, double, int>> generators) {
+            for (const auto &gen : generators) {
+                const std::string &unit = std::get<0>(gen);
+                double value = std::get<1>(gen);
+                const int base = std::get<2>(gen);
+                double mult = base == 2 ? 1024.0 : 1000.0;
+                std::vector<std::string> prefixes = base == 2 ?
+                        std::vector<std::string>{"Ki", "Mi", "Gi", "Ti", "Pi", "Ei", "Zi", "Yi"} :
+                        std::vector<std::string>{"k", "M", "G", "T", "P", "E", "Z", "Y"};
+                emplace(unit, value);
+                for (const auto &prefix : prefixes) {
+                    value *= mult;
+                    emplace(prefix + unit, value);
+                }
+            }
+        }
+    };
+
+    static double parseValueWithUnit(const std::string &string, const unit_scale &units, const char *default_unit) {
+        char *ptr;
+        const char *c_string = string.c_str();
+        errno = 0;
+
+        double res = strtod(c_string, &ptr);
+        if (errno == ERANGE) {
+            throw std::invalid_argument("Value out of range when parsing value " + string);
+        }
+        if (ptr == c_string) {
+            throw std::invalid_argument("Cannot parse value " + string);
+        }
+        if (ptr[0] == '\0') {
+            if (res == 0) {
+                return res; // Ok, 0 can be unit-less
+            }
+            ptr = (char *)default_unit;
+        }
+        auto u = units.find(ptr);
+        if (u == units.end()) {
+            throw std::invalid_argument("Unknown unit '" + std::string(ptr) + " when parsing value " + string);
+        }
+        return res * u->second;
+    }
+
+public:
+    static double parse_size(const std::string &string) {
+        static const unit_scale units{std::make_tuple("b", 0.125, 2), std::make_tuple("b", 0.125, 10),
+                                      std::make_tuple("B", 1.0, 2), std::make_tuple("B", 1.0, 10)};
+        return parseValueWithUnit(string, units, "B");
+    }
+
+    static double parse_compute_speed(const std::string &string) {
+        static const unit_scale units{std::make_tuple("f", 1.0, 10)};
+        return parseValueWithUnit(string, units, "f");
+    }
+
+    static double parse_bandwidth(const std::string &string) {
+        static const unit_scale units{std::make_tuple("bps", 0.125, 2), std::make_tuple("bps", 0.125, 10),
+                                      std::make_tuple("Bps", 1.0, 2), std::make_tuple("Bps", 1.0, 10)};
+        return parseValueWithUnit(string, units, "Bps");
+    }
+};
+
+/**
+ * @brief Check that both parsers agree on a string
+ *
+ * @param string: the string
+ * @param legacy: the previous parser's function
+ * @param parser: the parser's function
+ * @return true if both return the same value (or NaN), or both throw the same error
+ */
+static bool check(const std::string &string,
+                  const std::function<double(const std::string &)> &legacy,
+                  const std::function<double(const std::string &)> &parser) {
+    std::string legacy_result = "ok";
+    std::string result = "ok";
+    double legacy_value = 0.0;
+    double value = 0.0;
+    try {
+        legacy_value = legacy(string);
+    } catch (std::invalid_argument &e) {
+        legacy_result = e.what();
+    }
+    try {
+        value = parser(string);
+    } catch (std::invalid_argument &e) {
+        result = e.what();
+    }
+    bool same = (legacy_result == result) and
+                ((legacy_result != "ok") or (legacy_value == value) or ((legacy_value != legacy_value) and (value != value)));
+    if (not same) {
+        fprintf(stderr, "Mismatch on \"%s\": %s %.17g (previous parser: %s %.17g)\n", string.c_str(), result.c_str(),
+                value, legacy_result.c_str(), legacy_value);
+    }
+    return same;
+}
+
+int main(int argc, char **argv) {
+
+    const std::vector<std::string> values = {"0", "1", "2.5", "-3", "1e3", "1e400", "1e-400", "+4", ".5", "5.", "abc", "",
+                                             "  7", "1e", "0x10", "inf", "nan", "12345678901234567890", "3.14159e-5",
+                                             "+-1", "1e-310"};
+    const std::vector<std::string> units = {"", "B", "b", "kB", "KiB", "MB", "Mb", "GiB", "Yi", "YiB", "ZB", "Bps", "MBps",
+                                            "kbps", "Gibps", "f", "Gf", "Tf", "x", "kiB", "iB", "MiBps", "MMB", "Bpsx"};
+    const std::string characters = "0123456789.eE+-kMGTiBbpsf ";
+
+    // Fixed value/unit pairs, then random strings
+    std::vector<std::string> strings;
+    for (auto const &v : values) {
+        for (auto const &u : units) {
+            strings.push_back(v + u);
+        }
+    }
+    std::mt19937_64 rng(42);
+    for (int i = 0; i < 100000; i++) {
+        std::string string;
+        if (i % 2 == 0) {
+            string = std::to_string((double)(rng() % 100000) / (double)(1 + rng() % 1000)) + units[rng() % units.size()];
+        } else {
+            for (unsigned long n = rng() % 8; n > 0; n--) {
+                string += characters[rng() % characters.size()];
+            }
+        }
+        strings.push_back(string);
+    }
+
+    unsigned long num_mismatches = 0;
+    for (auto const &string : strings) {
+        num_mismatches += not check(string, LegacyUnitParser::parse_size,
+                                    [](const std::string &s) { return UnitParser::parse_size(s); });
+        num_mismatches += not check(string, LegacyUnitParser::parse_bandwidth,
+                                    [](const std::string &s) { return UnitParser::parse_bandwidth(s); });
+        num_mismatches += not check(string, LegacyUnitParser::parse_compute_speed,
+                                    [](const std::string &s) { return UnitParser::parse_compute_speed(s); });
+    }
+    fprintf(stdout, "%lu strings, %lu mismatches\n", strings.size(), num_mismatches);
+
+    if ((argc > 1) and (std::string(argv[1]) == "benchmark")) {
+        const std::vector<std::string> specs = {"100MBps", "80kbps", "1.5GiBps", "466MBps", "59.9MBps", "13.3MBps"};
+        const unsigned long num_parses = 2000000;
+        double sum = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned long i = 0; i < num_parses; i++) {
+            sum += LegacyUnitParser::parse_bandwidth(specs[i % specs.size()]);
+        }
+        auto middle = std::chrono::steady_clock::now();
+        for (unsigned long i = 0; i < num_parses; i++) {
+            sum -= UnitParser::parse_bandwidth(specs[i % specs.size()]);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double legacy_time = std::chrono::duration<double, std::nano>(middle - start).count() / (double)num_parses;
+        double time = std::chrono::duration<double, std::nano>(end - middle).count() / (double)num_parses;
+        fprintf(stdout, "parse_bandwidth: %.1lf ns (previous parser: %.1lf ns, speedup %.2lf, checksum %g)\n",
+                time, legacy_time, legacy_time / time, sum);
+    }
+
+    return num_mismatches == 0 ? 0 : 1;
+}